@@ -1,5 +1,10 @@
 // Sketch to help test the speed and function of the display
 // routines in the PololuOLED library.
+//
+// The results are printed to the serial monitor as CSV: one line per
+// operation, with the time it took in microseconds and, unless you are using
+// the Pololu3piPlus32U4 library, the numbers of data bytes, command bytes,
+// DC pin changes, and transfers it sent to the display.
 
 #include <PololuOLED.h>
 
@@ -7,6 +12,7 @@
 // USE_GENERIC and uncomment one of the other options if you want
 // to benchmark a different class.
 #define USE_GENERIC
+//#define USE_SPI
 //#define USE_POLOLU_3PI_PLUS_32U4_LIB
 
 #ifdef USE_POLOLU_3PI_PLUS_32U4_LIB
@@ -16,11 +22,25 @@ OLED display;
 #endif
 
 #ifdef USE_GENERIC
-PololuSH1106 display(1, 30, 0, 17, 13);
+#include <PololuSH1106Counting.h>
+#define COUNT_BUS_TRAFFIC
+PololuSH1106Main<PololuSH1106CountingCore<PololuSH1106Core>> display;
+void setPins() { display.core.setPins(1, 30, 0, 17, 13); }
+#endif
+
+#ifdef USE_SPI
+#include <PololuSH1106SPI.h>
+#include <PololuSH1106Counting.h>
+#define COUNT_BUS_TRAFFIC
+PololuSH1106Main<PololuSH1106CountingCore<PololuSH1106SPICore>> display;
+void setPins() { display.core.setPins(0, 17, 13); }
 #endif
 
 uint32_t startTime;
 uint32_t benchmarkTime;
+#ifdef COUNT_BUS_TRAFFIC
+PololuSH1106BusCounts benchmarkCounts;
+#endif
 
 uint8_t graphics[8 * 128];
 
@@ -79,6 +99,9 @@ void drawGraphics()
 
 void setup()
 {
+#ifdef COUNT_BUS_TRAFFIC
+  setPins();
+#endif
   drawGraphics();
   display.loadCustomCharacter(clockwiseChar, 6);
   display.loadCustomCharacter(counterClockwiseChar, 7);
@@ -86,67 +109,126 @@ void setup()
   delay(1000);
 }
 
+// Fills the text buffer without writing to the display.
+void writeTestText()
+{
+  display.noAutoDisplay();
+  display.gotoXY(0, 0);
+  display.print(F("\6 P1   \7"));
+  display.gotoXY(0, 1);
+  display.print(F("\6 P2   \7"));
+  display.gotoXY(0, 2);
+  display.print(F("0123456789 0123456789"));
+  display.gotoXY(0, 3);
+  display.print(F("ABCDEFGHIJKLMNOPQRSTU"));
+  display.gotoXY(0, 4);
+  display.print(F("\6\6\6\6\6           \7\7\7\7\7"));
+  display.gotoXY(0, 5);
+  display.print(F(" \6\6\6\6\6         \7\7\7\7\7 "));
+  display.gotoXY(0, 6);
+  display.print(F("  \6\6\6\6\6       \7\7\7\7\7  "));
+  display.gotoXY(0, 7);
+  display.print(F("   \6\6\6\6\6     \7\7\7\7\7   "));
+}
+
 void benchmarkStart()
 {
+#ifdef COUNT_BUS_TRAFFIC
+  display.core.resetCounts();
+#endif
   startTime = micros();
 }
 
 void benchmarkEnd()
 {
   benchmarkTime = micros() - startTime;
+#ifdef COUNT_BUS_TRAFFIC
+  benchmarkCounts = display.core.getCounts();
+#endif
 }
 
 void benchmarkReport(const __FlashStringHelper * name)
 {
-  uint8_t nameLength = Serial.print(name);
-  Serial.print(F(": "));
-  for (uint8_t i = nameLength; i < 50; i++) { Serial.print(' '); }
-  Serial.println(benchmarkTime);
+  Serial.print('"');
+  Serial.print(name);
+  Serial.print(F("\","));
+  Serial.print(benchmarkTime);
+#ifdef COUNT_BUS_TRAFFIC
+  Serial.print(',');
+  Serial.print(benchmarkCounts.dataBytes);
+  Serial.print(',');
+  Serial.print(benchmarkCounts.commandBytes);
+  Serial.print(',');
+  Serial.print(benchmarkCounts.dcToggles);
+  Serial.print(',');
+  Serial.print(benchmarkCounts.transfers);
+#else
+  Serial.print(F(",,,,"));
+#endif
+  Serial.println();
 
   delay(1000);
 }
 
 void loop()
 {
+  Serial.println(F("operation,micros,data_bytes,command_bytes,dc_toggles,transfers"));
+
   display.clear();
   display.setLayout8x2();
   display.display(); // first display takes extra time clearing RAM
 
-  display.noAutoDisplay();
-  display.gotoXY(0, 0);
-  display.print(F("\6 P1   \7"));
-  display.gotoXY(0, 1);
-  display.print(F("\6 P2   \7"));
-  display.gotoXY(0, 2);
-  display.print(F("0123456789 0123456789"));
-  display.gotoXY(0, 3);
-  display.print(F("ABCDEFGHIJKLMNOPQRSTU"));
-  display.gotoXY(0, 4);
-  display.print(F("\6\6\6\6\6           \7\7\7\7\7"));
-  display.gotoXY(0, 5);
-  display.print(F(" \6\6\6\6\6         \7\7\7\7\7 "));
-  display.gotoXY(0, 6);
-  display.print(F("  \6\6\6\6\6       \7\7\7\7\7  "));
-  display.gotoXY(0, 7);
-  display.print(F("   \6\6\6\6\6     \7\7\7\7\7   "));
+  writeTestText();
 
+  display.markAllDirty();  // otherwise display() only writes changed text
   benchmarkStart();
   display.display();
   benchmarkEnd();
   benchmarkReport(F("8x2, full update"));
 
+  // Characters that are already on the screen are not written again, so the
+  // text printed by each partial update below is different from the text it
+  // replaces in every cell.
   display.gotoXY(0, 0);
   benchmarkStart();
-  display.print(F("\6 P3   \7"));
+  display.print(F("ABCDEFGH"));
   benchmarkEnd();
   benchmarkReport(F("8x2, partial update, 1 char, 8 times"));
 
+  display.gotoXY(0, 0);
+  benchmarkStart();
+  display.beginUpdate();
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    display.write('a' + i);
+  }
+  display.endUpdate();
+  benchmarkEnd();
+  benchmarkReport(F("8x2, partial update, 1 char, 8 times, beginUpdate"));
+
   display.gotoXY(0, 1);
   benchmarkStart();
-  display.print("\6 P4   \7");
+  display.print("\7ABCDEF\6");
   benchmarkEnd();
   benchmarkReport(F("8x2, partial update, 8 chars"));
 
+  benchmarkStart();
+  display.loadCustomCharacter(counterClockwiseChar, 6);
+  display.display();
+  benchmarkEnd();
+  benchmarkReport(F("8x2, loadCustomCharacter and display"));
+  display.loadCustomCharacter(clockwiseChar, 6);
+
+  benchmarkStart();
+  display.scrollDisplayUp();
+  benchmarkEnd();
+  benchmarkReport(F("8x2, scrollDisplayUp"));
+
+  benchmarkStart();
+  display.clear();
+  benchmarkEnd();
+  benchmarkReport(F("8x2, clear"));
+
   display.setLayout8x2WithGraphics(graphics);
   display.display(); // first display takes extra time clearing RAM
 
@@ -157,19 +239,20 @@ void loop()
 
   display.gotoXY(0, 0);
   benchmarkStart();
-  display.print(F("\6 P5   \7"));
+  display.print(F("ABCDEFGH"));
   benchmarkEnd();
   benchmarkReport(F("8x2+graphics, partial update, 1 char, 8 times"));
 
   display.gotoXY(0, 1);
   benchmarkStart();
-  display.print("\6 P6   \7");
+  display.print("ABCDEFGH");
   benchmarkEnd();
   benchmarkReport(F("8x2+graphics, partial update, 8 chars"));
 
   display.setLayout11x4();
   display.display(); // first display takes extra time clearing RAM
 
+  display.markAllDirty();  // otherwise display() only writes changed text
   benchmarkStart();
   display.display();
   benchmarkEnd();
@@ -177,7 +260,7 @@ void loop()
 
   display.gotoXY(0, 0);
   benchmarkStart();
-  display.print("\6 P7   \7");
+  display.print("abcdefgh");
   benchmarkEnd();
   benchmarkReport(F("11x4, partial update, 8 chars"));
 
@@ -191,13 +274,15 @@ void loop()
 
   display.gotoXY(0, 1);
   benchmarkStart();
-  display.print("\6 P8   \7");
+  display.print("abcdefgh");
   benchmarkEnd();
   benchmarkReport(F("11x4+graphics, partial update, 8 chars"));
 
   display.setLayout21x8();
   display.display(); // first display takes extra time clearing RAM
 
+  writeTestText();
+  display.markAllDirty();  // otherwise display() only writes changed text
   benchmarkStart();
   display.display();
   benchmarkEnd();
@@ -205,10 +290,27 @@ void loop()
 
   display.gotoXY(0, 0);
   benchmarkStart();
-  display.print("\6 P9   \7");
+  display.print("ABCDEFGH");
   benchmarkEnd();
   benchmarkReport(F("21x8, partial update, 8 chars"));
 
+  benchmarkStart();
+  display.scrollDisplayUp();
+  benchmarkEnd();
+  benchmarkReport(F("21x8, scrollDisplayUp"));
+
+  display.hardwareScroll();
+  benchmarkStart();
+  display.scrollDisplayUp();
+  benchmarkEnd();
+  benchmarkReport(F("21x8, scrollDisplayUp, hardwareScroll"));
+  display.noHardwareScroll();
+
+  benchmarkStart();
+  display.clear();
+  benchmarkEnd();
+  benchmarkReport(F("21x8, clear"));
+
   display.setLayout21x8WithGraphics(graphics);
   display.display(); // first display takes extra time clearing RAM
 
@@ -219,9 +321,32 @@ void loop()
 
   display.gotoXY(0, 1);
   benchmarkStart();
-  display.print("\6 P10  \7");
+  display.print("ABCDEFGH");
   benchmarkEnd();
-  benchmarkReport(F("21x8, partial update, 8 chars"));
+  benchmarkReport(F("21x8+graphics, partial update, 8 chars"));
+
+  benchmarkStart();
+  display.displayGraphicsRect(44, 24, 40, 16);
+  benchmarkEnd();
+  benchmarkReport(F("21x8+graphics, displayGraphicsRect, 40x16"));
+
+  // Use the graphics buffer as a bank of 128 RAM tiles, so every character
+  // in the text buffer shows one of them.
+  static const PololuSH1106TileSet tileSet = { nullptr, graphics, 128 };
+  display.setLayoutTiles(&tileSet);
+  display.display(); // first display takes extra time clearing RAM
+
+  display.markAllDirty();  // otherwise display() only writes changed tiles
+  benchmarkStart();
+  display.display();
+  benchmarkEnd();
+  benchmarkReport(F("16x8 tiles, full update"));
+
+  display.gotoXY(0, 2);
+  benchmarkStart();
+  display.print("ABCDEFGH");
+  benchmarkEnd();
+  benchmarkReport(F("16x8 tiles, partial update, 8 tiles"));
 
   Serial.println();
 
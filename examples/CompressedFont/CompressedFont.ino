@@ -0,0 +1,66 @@
+// This example shows how to use a compressed font.  Its tables take less
+// program space than the same font stored uncompressed, but it takes a
+// little longer to draw.
+//
+// The compressed font does not replace the built-in font: characters that
+// are not in it, and lines that do not use it, are still drawn with
+// pololuOledFont, so that stays in the program.  Together with the code that
+// decodes the font, this means that this sketch uses more program space than
+// one that only uses the built-in font.  Compressing a font only saves space
+// compared to adding the same font to your program uncompressed.
+//
+// font.cpp was generated from the font in the CustomFont example by running
+// this command in this directory:
+//
+//   python3 ../../extras/compress_font.py ../CustomFont/font.h > font.cpp
+//
+// The sketch alternates between the compressed font and the built-in font,
+// and prints how long each full update of the screen took to the serial
+// monitor, so you can see the extra time taken to decode the glyphs.
+
+#include <PololuOLED.h>
+
+extern const PololuOLEDCompressedFont compressedFont;
+
+// You will need to modify the pin numbers on the line below
+// to indicate what Arduino pins to use to control the display.
+// The pins are specified in this order: CLK, MOS, RES, DC, CS.
+// Pass 255 for RES, DC, or CS if you are not using them.
+PololuSH1106 display(1, 30, 0, 17, 13);
+
+void setup()
+{
+  display.setLayout21x8();
+  display.noAutoDisplay();
+  for (uint8_t y = 0; y < 8; y++)
+  {
+    display.gotoXY(0, y);
+    display.print(y, HEX);
+    display.print(F(": "));
+    for (uint8_t x = 0; x < 16; x++)
+    {
+      display.print((char)(0x20 + (y * 16 + x) % 0x60));
+    }
+  }
+  delay(1000);
+}
+
+void showFont(const PololuOLEDCompressedFont * font)
+{
+  display.setCompressedFont(font);
+
+  uint32_t start = micros();
+  display.display();
+  uint32_t time = micros() - start;
+
+  Serial.print(font ? F("Compressed font: ") : F("Built-in font: "));
+  Serial.print(time);
+  Serial.println(F(" us"));
+  delay(2000);
+}
+
+void loop()
+{
+  showFont(&compressedFont);
+  showFont(nullptr);
+}
@@ -0,0 +1,54 @@
+#include <PololuOLED.h>
+
+// Generated by compress_font.py from ../CustomFont/font.h.
+// 96 glyphs: 480 bytes uncompressed, 432 bytes compressed.
+
+static const uint8_t compressedFontDictionary[] PROGMEM = {
+  0x00, 0x41, 0x7F, 0x40, 0x04, 0x01, 0x44, 0x45, 0x02, 0x05, 0x08, 0x49,
+  0x10, 0x24, 0x54, 0x3E, 0x7C, 0x14, 0x80, 0x22, 0x30, 0x20, 0x28, 0x38,
+  0x06, 0x36, 0x3F, 0xFF, 0x03, 0x18, 0x1C, 0x48, 0x51, 0x71, 0x78, 0x0A,
+  0x3C, 0x5D, 0x7E, 0xA0, 0xA4, 0x09, 0x0F, 0x12, 0x2A,
+};
+
+static const uint16_t compressedFontGroupOffsets[] PROGMEM = {
+  0, 67, 120, 190, 253, 308, 354, 412, 469, 533, 592, 663,
+};
+
+static const uint8_t compressedFontCodes[] PROGMEM = {
+  0x00, 0x00, 0x00, 0xF0, 0x5F, 0x00, 0xD0, 0x0F, 0xFD, 0xD0, 0x24, 0x4D,
+  0xD2, 0xD4, 0xE0, 0xFF, 0x6B, 0xFE, 0xEE, 0x3F, 0xD4, 0xA7, 0xBD, 0x1F,
+  0xD6, 0xF7, 0x4A, 0x8E, 0x2F, 0xE3, 0x02, 0xD0, 0x0F, 0xE0, 0xD1, 0x16,
+  0x01, 0x11, 0x6D, 0x1E, 0xD0, 0xA4, 0xDA, 0x04, 0xCC, 0x3D, 0xCC, 0x00,
+  0x0F, 0x0E, 0xC0, 0xCC, 0xCC, 0x00, 0x0F, 0x06, 0x30, 0x7D, 0xDA, 0x5B,
+  0x2D, 0x3E, 0x7B, 0x2D, 0xF3, 0x42, 0x32, 0xF3, 0x62, 0x3E, 0xBB, 0x6F,
+  0xD4, 0x16, 0xBB, 0xCD, 0x0E, 0x4D, 0xEE, 0x1F, 0x21, 0x7F, 0x72, 0x77,
+  0x9F, 0xE3, 0xF7, 0x4A, 0xBB, 0x7D, 0xFD, 0xE5, 0xE4, 0xFC, 0x07, 0xCD,
+  0xBB, 0xDB, 0xDC, 0xBB, 0xFB, 0x29, 0xEF, 0x01, 0xF0, 0x66, 0x00, 0x00,
+  0x6F, 0x0E, 0xA0, 0x4D, 0x6D, 0x01, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0xD1,
+  0xD6, 0xA4, 0x80, 0xE5, 0xE3, 0xDC, 0xDB, 0x12, 0x8E, 0x8E, 0xEF, 0xE5,
+  0x99, 0x99, 0x9E, 0x72, 0x77, 0xAF, 0xD3, 0x12, 0x11, 0x6D, 0x12, 0x11,
+  0x2D, 0x72, 0x17, 0x21, 0x99, 0x55, 0x2D, 0x11, 0xF7, 0x3D, 0x42, 0x44,
+  0x02, 0x21, 0x01, 0x8D, 0x33, 0xD3, 0x2D, 0x44, 0x6E, 0x4E, 0x32, 0x33,
+  0x23, 0x48, 0x28, 0x82, 0xA4, 0xD2, 0x12, 0x11, 0x2D, 0x92, 0x99, 0xD8,
+  0x12, 0xF1, 0x21, 0xEF, 0x25, 0x99, 0xF9, 0x7A, 0x6D, 0x77, 0xF7, 0x39,
+  0x55, 0x52, 0xD5, 0x3D, 0x33, 0xDD, 0xDE, 0x7D, 0xD3, 0xE7, 0x2D, 0x8D,
+  0xDC, 0x28, 0x4E, 0x6E, 0xE4, 0xE6, 0x54, 0xD8, 0x83, 0xF5, 0x61, 0x3E,
+  0x7B, 0x3F, 0x04, 0x12, 0x01, 0xD5, 0xAB, 0x7D, 0x03, 0x11, 0x02, 0x84,
+  0x85, 0xD4, 0xD5, 0xD5, 0xD5, 0xD5, 0x05, 0x80, 0x05, 0x8D, 0x1D, 0x1D,
+  0x1D, 0x5E, 0xE2, 0x62, 0xD6, 0xDA, 0x6A, 0x66, 0x9D, 0xAD, 0x66, 0x2E,
+  0xD2, 0xDA, 0xD1, 0xD1, 0xF1, 0x58, 0xE4, 0x99, 0x09, 0x8F, 0xE9, 0xEB,
+  0xEB, 0xDB, 0x23, 0x4A, 0xE4, 0x05, 0xF0, 0x7D, 0x00, 0x0F, 0xD6, 0xD5,
+  0xD5, 0xF5, 0x7D, 0xC2, 0x9D, 0x06, 0xD0, 0x3D, 0x00, 0x3D, 0xE4, 0x40,
+  0x5E, 0x3D, 0x44, 0xE4, 0xD5, 0x6A, 0x66, 0xAD, 0xCF, 0xDF, 0xD9, 0xD0,
+  0xE0, 0xE0, 0xD0, 0xD0, 0xD0, 0xF9, 0xFC, 0x3D, 0x4A, 0xA4, 0x2E, 0x1D,
+  0x1D, 0x1D, 0x0D, 0x80, 0xDD, 0x2F, 0x04, 0x7E, 0x33, 0xD3, 0xE3, 0xD1,
+  0x38, 0x8D, 0x1E, 0x7E, 0xF3, 0x70, 0xD3, 0x63, 0x9D, 0xDC, 0x69, 0xCF,
+  0xE9, 0xEA, 0xEA, 0xDA, 0x63, 0x4F, 0xD6, 0xF1, 0x4C, 0xA6, 0xCD, 0x11,
+  0x00, 0xF0, 0x77, 0x00, 0x11, 0xCD, 0x0A, 0x58, 0x85, 0xD5, 0xDE, 0xDE,
+  0xDE, 0xDE, 0x0E,
+};
+
+extern const PololuOLEDCompressedFont compressedFont = {
+  0x20, 0x7F, 5, 1, 13, 3,
+  compressedFontDictionary, compressedFontGroupOffsets, compressedFontCodes
+};
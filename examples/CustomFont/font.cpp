@@ -31,6 +31,12 @@
 // declaration into a replacement of the variable pololuOledFont in the
 // library.  If it doesn't match exactly, you will either get an error or
 // still have the original font.
+//
+// You can also compress the font with extras/compress_font.py and draw it
+// with setCompressedFont(), as shown in the CompressedFont example.  A
+// compressed font takes less program space than the same font stored
+// uncompressed, but the decoder and the extra font still make the program
+// bigger than it would be using only the built-in font.
 
 #define font_bits unused_placeholder; extern const uint8_t PROGMEM pololuOledFont
 #include "font.h"
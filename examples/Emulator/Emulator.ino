@@ -0,0 +1,71 @@
+// This sketch shows how to use PololuSH1106Emulator to see what the library
+// would show on the display without having a display connected.
+//
+// It draws each layout in an emulated SH1106 and prints the resulting image
+// to the serial monitor as a plain PBM file.  You can copy each image,
+// starting at the "P1" line, to a file with a .pbm extension and open it with
+// most image viewers, or compare the images printed by two versions of the
+// library.
+//
+// The emulator uses about 1 KB of RAM for its copy of the display RAM, so
+// instead of a 1 KB graphics buffer this sketch draws its graphics one page
+// at a time with a callback, which fits on boards with 2 KB of RAM.
+
+#include <PololuOLED.h>
+#include <PololuSH1106Emulator.h>
+
+PololuSH1106Emulator display;
+
+uint8_t pageStrip[128];
+
+// Draws two short vertical lines on each page, one near each edge.
+void drawPage(uint8_t page, uint8_t * strip)
+{
+  strip[page] = 0xFF;
+  strip[127 - page] = 0xFF;
+}
+
+void printImage(const __FlashStringHelper * name)
+{
+  Serial.println(name);
+  display.core.dumpPbm(Serial);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial) {}
+
+  for (uint8_t line = 0; line < 8; line++)
+  {
+    memset(display.getLinePointer(line), '0' + line, 21);
+  }
+
+  display.setLayout8x2();
+  display.display();
+  printImage(F("8x2"));
+
+  display.setLayout8x2WithGraphicsCallback(drawPage, pageStrip);
+  display.display();
+  printImage(F("8x2 with graphics"));
+
+  display.setLayout11x4();
+  display.display();
+  printImage(F("11x4"));
+
+  display.setLayout11x4WithGraphicsCallback(drawPage, pageStrip);
+  display.display();
+  printImage(F("11x4 with graphics"));
+
+  display.setLayout21x8();
+  display.display();
+  printImage(F("21x8"));
+
+  display.setLayout21x8WithGraphicsCallback(drawPage, pageStrip);
+  display.display();
+  printImage(F("21x8 with graphics"));
+}
+
+void loop()
+{
+}
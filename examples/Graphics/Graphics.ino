@@ -142,4 +142,24 @@ void loop()
   display.display();
   delay(2000);
 
+  // Sparkline: a 40x16 graph that scrolls left as new values come in.  Only
+  // its rectangle is written, which is much faster than display().
+  clearGraphics();
+  display.noAutoDisplay();
+  display.clear();
+  display.print(F("sparkline"));
+  display.display();
+  for (uint8_t i = 0; i < 80; i++)
+  {
+    for (uint8_t x = 44; x < 83; x++)
+    {
+      graphics[x + 4 * 128] = graphics[x + 1 + 4 * 128];
+      graphics[x + 5 * 128] = graphics[x + 1 + 5 * 128];
+    }
+    graphics[83 + 4 * 128] = 0;
+    graphics[83 + 5 * 128] = 0;
+    setPixel(83, 32 + random(0, 16), 1);
+    display.displayGraphicsRect(44, 32, 40, 16);
+    delay(25);
+  }
 }
@@ -0,0 +1,66 @@
+// This example shows how to display text and graphics on the OLED at the
+// same time without a 1024-byte graphics buffer.
+//
+// Instead of keeping a picture of the whole screen in RAM, the sketch keeps
+// the last 128 readings of analog input A0 and draws them as a bar chart one
+// page (8-pixel-high row) at a time, just before the library writes that
+// page.  This only takes 128 bytes for the readings and 128 bytes for the
+// strip that each page is drawn on.
+
+#include <PololuOLED.h>
+
+// You will need to modify the pin numbers on the line below
+// to indicate what Arduino pins to use to control the display.
+// The pins are specified in this order: CLK, MOS, RES, DC, CS.
+// Pass 255 for RES, DC, or CS if you are not using them.
+PololuSH1106 display(1, 30, 0, 17, 13);
+
+// The heights of the bars, from 0 to 47 pixels, oldest first.  The chart
+// fills the bottom 6 pages of the screen, below the first line of text.
+const uint8_t chartHeight = 48;
+uint8_t readings[128];
+
+uint8_t pageStrip[128];
+
+// Draws one page of the chart on the strip, which the library has already
+// cleared.  Each byte of the strip is a 1x8 vertical column of pixels, with
+// the least-significant bit holding the top-most pixel.
+void drawPage(uint8_t page, uint8_t * strip)
+{
+  const uint8_t pageTop = page * 8;
+  for (uint8_t x = 0; x < 128; x++)
+  {
+    const uint8_t barTop = 64 - readings[x];
+    if (barTop <= pageTop)
+    {
+      strip[x] = 0xFF;
+    }
+    else if (barTop < pageTop + 8)
+    {
+      strip[x] = 0xFF << (barTop - pageTop);
+    }
+  }
+}
+
+void setup()
+{
+  display.setLayout21x8WithGraphicsCallback(drawPage, pageStrip);
+}
+
+void loop()
+{
+  const uint16_t reading = analogRead(A0);
+
+  memmove(readings, readings + 1, sizeof(readings) - 1);
+  readings[127] = (uint32_t)reading * chartHeight / 1024;
+
+  // Update the text and the whole chart at once.
+  display.noAutoDisplay();
+  display.gotoXY(0, 0);
+  display.print(F("A0: "));
+  display.print(reading);
+  display.print(F("   "));
+  display.display();
+
+  delay(50);
+}
@@ -78,4 +78,12 @@ void loop()
   display.setLayout21x8WithGraphics(graphics);
   display.display();
   delay(2000);
+
+  display.setLayoutScaled(4, 4);  // 5 columns and 2 rows
+  display.display();
+  delay(2000);
+
+  display.setLayoutScaledWithGraphics(2, 1, graphics);  // 10 columns and 8 rows
+  display.display();
+  delay(2000);
 }
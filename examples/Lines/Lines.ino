@@ -1,11 +1,15 @@
 // This is a simple screensaver-like example combining text
 // and graphics.
 //
-// You will need to install the Adafruit_SSD1306 library using
+// It draws with the Adafruit GFX Library on a PololuSH1106Canvas, which
+// keeps track of which parts of the screen changed, so each step only sends
+// the columns that the two lines touched instead of the whole screen.
+//
+// You will need to install the Adafruit GFX Library using
 // the Library Manager to compile this sketch.
 
 #include <PololuOLED.h>
-#include <Adafruit_SSD1306.h>
+#include <PololuSH1106Canvas.h>
 
 // You will need to modify the pin numbers on the line below
 // to indicate what Arduino pins to use to control the display.
@@ -13,7 +17,7 @@
 // Pass 255 for RES, DC, or CS if you are not using them.
 PololuSH1106 display(1, 30, 0, 17, 13);
 
-Adafruit_SSD1306 gfx(128, 64, 13, 13, 13, 13, 13);
+PololuSH1106Canvas gfx;
 
 struct MovingPoint
 {
@@ -32,22 +36,13 @@ void setup()
 {
   delay(1000);
 
-  if (!gfx.begin())
-  {
-    while (1)
-    {
-      Serial.println(F("Allocation failed."));
-      delay(1000);
-    }
-  }
-
   display.setLayout8x2WithGraphics(gfx.getBuffer());
 
-  gfx.clearDisplay();
   display.noAutoDisplay();
   display.print(F("Text and"));
   display.gotoXY(0,1);
   display.print(F("graphics"));
+  display.display();
 }
 
 void move(MovingPoint &p)
@@ -61,7 +56,7 @@ void move(MovingPoint &p)
 void loop()
 {
   // draw the leading line
-  gfx.drawLine(p1.x, p1.y, p2.x, p2.y, SSD1306_INVERSE);
+  gfx.drawLine(p1.x, p1.y, p2.x, p2.y, POLOLU_SH1106_INVERSE);
   move(p1);
   move(p2);
   if(count == 0)
@@ -69,7 +64,7 @@ void loop()
     // COUNT steps behind, draw a line to erase the old lines.
     // Note that both drawing functions use the INVERSE option,
     // which handles overlapping in a simple way.
-    gfx.drawLine(op1.x, op1.y, op2.x, op2.y, SSD1306_INVERSE);
+    gfx.drawLine(op1.x, op1.y, op2.x, op2.y, POLOLU_SH1106_INVERSE);
     move(op1);
     move(op2);
   }
@@ -78,5 +73,6 @@ void loop()
     count -= 1;
   }
 
-  display.display();
+  // Write just the parts of the screen that changed.
+  gfx.display(display);
 }
@@ -0,0 +1,65 @@
+// This sketch shows how to use PololuSH1106Multi to control two displays
+// that share their CLK, MOS, RES, and DC lines but have separate CS lines.
+//
+// Each display shows a counter, and the displays are updated a little at a
+// time by displayFor(), so the loop never spends more than about 2 ms
+// writing to them.
+
+#include <PololuOLED.h>
+#include <PololuSH1106Multi.h>
+
+PololuSH1106Multi<PololuSH1106Core, 2> displays;
+
+const uint8_t smileyChar[] PROGMEM = {
+  0b00000,
+  0b01010,
+  0b01010,
+  0b00000,
+  0b10001,
+  0b01110,
+  0b00000,
+  0b00000,
+};
+
+void setup()
+{
+  // You will need to modify the pin numbers below to indicate what Arduino
+  // pins to use to control the displays.  The pins are specified in this
+  // order: CLK, MOS, RES, DC, CS.  Only the first display gets the RES pin,
+  // since resetting one display resets both of them.
+  displays[0].core.setPins(1, 30, 0, 17, 13);
+  displays[1].core.setPins(1, 30, 255, 17, 14);
+  displays.init();
+
+  displays.loadCustomCharacter(smileyChar, 0);
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    displays[i].setLayout11x4();
+    displays[i].noAutoDisplay();
+    displays[i].clear();
+    displays[i].print(F("Display "));
+    displays[i].print(i);
+    displays[i].gotoXY(0, 3);
+    displays[i].print('\0');
+  }
+}
+
+void loop()
+{
+  static uint16_t count;
+  static bool done = true;
+
+  if (done)
+  {
+    // Start updating the displays with new text.
+    count++;
+    for (uint8_t i = 0; i < 2; i++)
+    {
+      displays[i].noAutoDisplay();
+      displays[i].gotoXY(0, 1);
+      displays[i].print(count * (i + 1));
+    }
+  }
+
+  done = displays.displayFor(2000);
+}
@@ -0,0 +1,47 @@
+// This example shows how to use a proportional font, which fits more text
+// on each line than the built-in font because narrow characters take up
+// less room.  The font is defined in font.cpp.
+//
+// The text buffer is made 32 characters wide with the third template
+// parameter of PololuSH1106Main so that the lines using the proportional
+// font can hold more than the usual 21 characters.
+
+#include <PololuOLED.h>
+
+extern const PololuOLEDFont proportionalFont;
+
+PololuSH1106Main<PololuSH1106Core, 32, 8> display;
+
+void setup()
+{
+  // You will need to modify the pin numbers below to indicate what Arduino
+  // pins to use to control the display.  The pins are specified in this
+  // order: CLK, MOS, RES, DC, CS.  Pass 255 for RES, DC, or CS if you are not
+  // using them.
+  display.core.setPins(1, 30, 0, 17, 13);
+
+  display.setLayout21x8();
+
+  // Use the proportional font on every line except line 0.
+  display.setFont(&proportionalFont, 0b11111110);
+
+  display.noAutoDisplay();
+  display.clear();
+  display.print(F("Built-in font:"));
+  display.gotoXY(0, 1);
+  display.print(F("Proportional font:"));
+  display.gotoXY(0, 3);
+  display.print(F("The quick brown fox jumps"));
+  display.gotoXY(0, 4);
+  display.print(F("over the lazy dog."));
+  display.display();
+}
+
+void loop()
+{
+  display.gotoXY(0, 6);
+  display.print(F("Uptime: "));
+  display.print(millis() / 1000);
+  display.print(F(" seconds"));
+  delay(100);
+}
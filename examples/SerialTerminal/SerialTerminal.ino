@@ -2,6 +2,12 @@
 // scrolling the text up when it reaches the bottom.
 // Backspace/delete and newline/carriage return are supported,
 // and Ctrl+L will clear the screen.
+//
+// The library's terminal mode handles these characters, so the sketch just
+// passes everything it receives to the display.  The lines that scroll off
+// the top are saved in a scrollback buffer, and sending Ctrl+U or Ctrl+D
+// (which are not displayed) scrolls the view back through them or returns
+// it to the bottom.
 
 #include <PololuOLED.h>
 
@@ -11,63 +17,45 @@
 // Pass 255 for RES, DC, or CS if you are not using them.
 PololuSH1106 display(1, 30, 0, 17, 13);
 
+// Room for 16 lines of 21 characters.
+PololuSH1106ScrollbackBuffer<16> scrollback;
+
 void setup()
 {
   delay(1000);
   display.setLayout21x8();
+  display.terminalMode();
+  display.hardwareScroll();
+  display.setScrollbackBuffer(&scrollback);
   display.clear();
-  Serial.begin(9600);
-}
-
-void newLine()
-{
-  if(display.getY() < 7)
-  {
-    display.gotoXY(0, display.getY()+1);
-  }
-  else
-  {
-    display.gotoXY(0, 7);
-    display.scrollDisplayUp();
-  }
-}
-
-void backspace()
-{
-  if(display.getX() == 0)
-  {
-    return;
-  }
-  display.gotoXY(display.getX() - 1, display.getY());
-  display.print(' ');
-  display.gotoXY(display.getX() - 1, display.getY());
+  Serial.begin(115200);
 }
 
 void loop()
-{  if(Serial.available())
+{
+  // Read all the characters that are available and write them to the
+  // display at once, which is much faster than writing them one at a time.
+  uint8_t buffer[32];
+  uint8_t length = 0;
+  while (length < sizeof(buffer) && Serial.available())
   {
     char c = Serial.read();
     switch(c)
     {
-    case '\n':
-    case '\r':
-      newLine();
-      break;
-    case '\x0c':
-      display.clear();
+    case '\x15':  // Ctrl+U
+      display.setScrollbackView(display.getScrollbackView() + 4);
       break;
-    case '\x7f':
-    case '\x08':
-      backspace();
+    case '\x04':  // Ctrl+D
+      display.setScrollbackView(0);
       break;
     default:
-      display.print(c);
+      buffer[length++] = c;
       break;
     }
-    
-    if(display.getX() >= 21)
-    {
-      newLine();
-    }
+  }
+
+  if (length)
+  {
+    display.write(buffer, length);
   }
 }
@@ -0,0 +1,92 @@
+// This sketch shows how to use the tile layout to draw graphics that cover
+// the whole screen without a 1024-byte graphics buffer.
+//
+// The screen is a 16x8 grid of 8x8 tiles, and the text buffer holds the
+// number of the tile in each cell.  Moving the ball only changes two cells,
+// so only those two tiles are written to the display.  The ball itself is a
+// tile in RAM that the sketch redraws to make it pulse.
+
+#include <PololuOLED.h>
+
+// A 16x8 text buffer is all this layout needs.
+PololuSH1106Main<PololuSH1106Core, 16, 8> display;
+
+// Tile 0 is in RAM, and the tiles in program space start at 1.
+const uint8_t ballTile = 0;
+const uint8_t blankTile = 1;
+const uint8_t brickTile = 2;
+const uint8_t heartTile = 3;
+
+// Each tile is 8 columns from left to right, with the least-significant bit
+// of each byte at the top.
+const uint8_t tiles[] PROGMEM = {
+  // blankTile
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // brickTile
+  0x77, 0x77, 0x77, 0x70, 0x77, 0x77, 0x77, 0x07,
+  // heartTile
+  0x06, 0x0F, 0x1F, 0x3E, 0x1F, 0x0F, 0x06, 0x00,
+};
+
+const uint8_t solidBall[8] = { 0x3C, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0x3C };
+const uint8_t hollowBall[8] = { 0x3C, 0x42, 0x81, 0x81, 0x81, 0x81, 0x42, 0x3C };
+
+uint8_t ramTiles[8];
+
+const PololuSH1106TileSet tileSet = { tiles, ramTiles, 1 };
+
+uint8_t ballX = 3, ballY = 2;
+int8_t speedX = 1, speedY = 1;
+
+// Returns the tile that goes in a cell when the ball is not there.
+uint8_t backgroundTile(uint8_t x, uint8_t y)
+{
+  if (x == 0 || x == 15 || y == 0 || y == 7) { return brickTile; }
+  if ((x == 11 && y == 2) || (x == 4 && y == 5)) { return heartTile; }
+  return blankTile;
+}
+
+void setup()
+{
+  // You will need to modify the pin numbers below to indicate what Arduino
+  // pins to use to control the display.  The pins are specified in this
+  // order: CLK, MOS, RES, DC, CS.  Pass 255 for RES, DC, or CS if you are not
+  // using them.
+  display.core.setPins(1, 30, 0, 17, 13);
+
+  memcpy(ramTiles, solidBall, 8);
+  display.setLayoutTiles(&tileSet);
+
+  // Draw a brick wall around the edges, a few hearts, and the ball.
+  for (uint8_t y = 0; y < 8; y++)
+  {
+    uint8_t * line = display.getLinePointer(y);
+    for (uint8_t x = 0; x < 16; x++)
+    {
+      line[x] = backgroundTile(x, y);
+    }
+  }
+  display.getLinePointer(ballY)[ballX] = ballTile;
+
+  display.display();
+}
+
+void loop()
+{
+  // Erase the ball and move it, bouncing off the walls.
+  display.gotoXY(ballX, ballY);
+  display.write(backgroundTile(ballX, ballY));
+  if (ballX + speedX == 0 || ballX + speedX == 15) { speedX = -speedX; }
+  if (ballY + speedY == 0 || ballY + speedY == 7) { speedY = -speedY; }
+  ballX += speedX;
+  ballY += speedY;
+  display.gotoXY(ballX, ballY);
+  display.write(ballTile);
+
+  // Alternate between the two ball pictures.
+  memcpy(ramTiles, (millis() & 512) ? hollowBall : solidBall, 8);
+  display.markTileDirty(ballTile);
+  display.display();
+
+  delay(100);
+}
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+
+# Converts a font stored in an X BitMap (xbm) file, in the format used by the
+# CustomFont example, into a PololuOLEDCompressedFont that can be used with
+# PololuSH1106Main::setCompressedFont().
+#
+# Usage:
+#
+#   python3 compress_font.py font.h > compressed_font.cpp
+#
+# Then add compressed_font.cpp to your sketch directory, declare the font in
+# your sketch with:
+#
+#   extern const PololuOLEDCompressedFont compressedFont;
+#
+# and call display.setCompressedFont(&compressedFont).
+#
+# The input image is 8 pixels wide, with each row holding one column of a
+# glyph and the glyphs following each other with no space in between.  Run
+# with --help to see the other options.
+#
+# The converter puts the most common columns in a dictionary so they can be
+# stored as one or two 4-bit codes, and tries every split between one-code
+# and two-code entries to find the smallest result.
+
+import argparse
+import collections
+import re
+import sys
+
+def read_xbm(path):
+  with open(path) as f:
+    text = f.read()
+  width = re.search(r'#define\s+\w*_width\s+(\d+)', text)
+  if width and int(width.group(1)) != 8:
+    sys.exit('%s: the image must be 8 pixels wide' % path)
+  body = text.split('{', 1)[1].split('}', 1)[0]
+  return [int(b, 16) for b in re.findall(r'0x([0-9a-fA-F]+)', body)]
+
+def encode(glyphs, short_codes, group_shift):
+  counts = collections.Counter(c for glyph in glyphs for c in glyph)
+  order = sorted(counts, key=lambda c: (-counts[c], c))
+  dictionary = order[:short_codes + (15 - short_codes) * 16]
+  index = {c: i for i, c in enumerate(dictionary)}
+
+  nibbles = []
+  offsets = []
+  for n, glyph in enumerate(glyphs):
+    if n % (1 << group_shift) == 0:
+      offsets.append(len(nibbles))
+    for column in glyph:
+      i = index.get(column)
+      if i is None:
+        nibbles += [15, column & 15, column >> 4]
+      elif i < short_codes:
+        nibbles.append(i)
+      else:
+        i -= short_codes
+        nibbles += [short_codes + (i >> 4), i & 15]
+
+  if len(nibbles) % 2:
+    nibbles.append(0)
+  codes = [nibbles[i] | nibbles[i + 1] << 4 for i in range(0, len(nibbles), 2)]
+  return dictionary, offsets, codes
+
+def table(values, fmt, per_line):
+  lines = []
+  for i in range(0, len(values), per_line):
+    lines.append('  ' + ', '.join(fmt % v for v in values[i:i + per_line]) + ',')
+  return '\n'.join(lines)
+
+def main():
+  parser = argparse.ArgumentParser(
+    description='Converts an xbm font to a PololuOLEDCompressedFont.')
+  parser.add_argument('input', help='the xbm file')
+  parser.add_argument('--name', default='compressedFont',
+    help='the name of the font variable (default: compressedFont)')
+  parser.add_argument('--first', type=lambda s: int(s, 0), default=0x20,
+    help='the character code of the first glyph (default: 0x20)')
+  parser.add_argument('--width', type=int, default=5,
+    help='the width of each glyph, in columns (default: 5)')
+  parser.add_argument('--spacing', type=int, default=1,
+    help='the number of blank columns after each glyph (default: 1)')
+  parser.add_argument('--group-shift', type=int, default=3, choices=range(8),
+    help='store the position of every (2 ** GROUP_SHIFT)th glyph; smaller '
+    'values make drawing faster and the font bigger (default: 3)')
+  args = parser.parse_args()
+
+  data = read_xbm(args.input)
+  count = min(len(data) // args.width, 256 - args.first)
+  if count == 0:
+    sys.exit('%s: no glyphs found' % args.input)
+  glyphs = [data[i * args.width:(i + 1) * args.width] for i in range(count)]
+
+  best = None
+  for short_codes in range(16):
+    dictionary, offsets, codes = encode(glyphs, short_codes, args.group_shift)
+    size = len(dictionary) + 2 * len(offsets) + len(codes)
+    if best is None or size < best[0]:
+      best = (size, short_codes, dictionary, offsets, codes)
+  size, short_codes, dictionary, offsets, codes = best
+  raw = count * args.width
+
+  sys.stderr.write('%d glyphs: %d bytes uncompressed, %d bytes compressed '
+    '(%d dictionary, %d index, %d codes), %.0f%% %s\n' % (count, raw,
+    size, len(dictionary), 2 * len(offsets), len(codes),
+    100.0 * abs(raw - size) / raw, 'smaller' if size <= raw else 'larger'))
+
+  prefix = args.name
+  print('''#include <PololuOLED.h>
+
+// Generated by compress_font.py from %s.
+// %d glyphs: %d bytes uncompressed, %d bytes compressed.
+
+static const uint8_t %sDictionary[] PROGMEM = {
+%s
+};
+
+static const uint16_t %sGroupOffsets[] PROGMEM = {
+%s
+};
+
+static const uint8_t %sCodes[] PROGMEM = {
+%s
+};
+
+extern const PololuOLEDCompressedFont %s = {
+  0x%02X, 0x%02X, %d, %d, %d, %d,
+  %sDictionary, %sGroupOffsets, %sCodes
+};''' % (args.input.replace('\\', '/'), count, raw, size,
+    prefix, table(dictionary, '0x%02X', 12),
+    prefix, table(offsets, '%d', 12),
+    prefix, table(codes, '0x%02X', 12),
+    args.name, args.first, args.first + count - 1, args.width, args.spacing,
+    short_codes, args.group_shift, prefix, prefix, prefix))
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,207 @@
+// Host benchmark for the display routines.  For each operation, this prints
+// a CSV line with the host time per operation in nanoseconds and the numbers
+// of data bytes, command bytes, DC pin changes, and transfers the operation
+// sends to the display, counted with PololuSH1106CountingCore.
+//
+// The core below discards the bytes, so the time is the time taken by the
+// library to render them, not the time it takes to send them to a display.
+// The traffic numbers do not depend on the machine, so they can be compared
+// between versions of the library to find regressions.
+//
+// Run "make bench" in this directory to build and run it.
+
+#include <PololuSH1106Counting.h>
+#include <chrono>
+
+// A core class that does nothing with the bytes it is given.
+class NullCore
+{
+public:
+  void initPins() { }
+  void reset() { }
+  void sh1106TransferStart() { }
+  void sh1106TransferEnd() { }
+  void sh1106CommandMode() { }
+  void sh1106DataMode() { }
+  void sh1106Write(uint8_t d) { sink += d; }
+
+  // Keeps the compiler from optimizing the writes away.
+  volatile uint8_t sink = 0;
+};
+
+typedef PololuSH1106Main<PololuSH1106CountingCore<NullCore>> Display;
+
+static Display display;
+static uint8_t graphics[1024];
+static uint32_t iteration;
+
+static const uint8_t customChar[] = {
+  0b01110, 0b10001, 0b10101, 0b10101, 0b11101, 0b00001, 0b10001, 0b01110,
+};
+
+static const uint8_t otherCustomChar[] = {
+  0b01110, 0b10001, 0b10101, 0b10101, 0b10111, 0b10000, 0b10001, 0b01110,
+};
+
+static void fillText()
+{
+  display.noAutoDisplay();
+  for (uint8_t y = 0; y < 8; y++)
+  {
+    display.gotoXY(0, y);
+    for (uint8_t x = 0; x < 21; x++)
+    {
+      display.write((uint8_t)((x + y) % 7 == 0 ? 6 : 'A' + (x + y) % 26));
+    }
+  }
+}
+
+// Each layout is benchmarked with the text in the buffer and every character
+// on the screen.
+static void setLayout8x2() { display.setLayout8x2(); }
+static void setLayout8x2WithGraphics()
+{
+  display.setLayout8x2WithGraphics(graphics);
+}
+static void setLayout11x4() { display.setLayout11x4(); }
+static void setLayout11x4WithGraphics()
+{
+  display.setLayout11x4WithGraphics(graphics);
+}
+static void setLayout21x8() { display.setLayout21x8(); }
+static void setLayout21x8WithGraphics()
+{
+  display.setLayout21x8WithGraphics(graphics);
+}
+
+static void prepareFullUpdate()
+{
+  // Otherwise display() only writes the text that changed.
+  display.markAllDirty();
+}
+
+static void fullUpdate()
+{
+  display.display();
+}
+
+static void preparePartialUpdate()
+{
+  display.gotoXY(0, 1);
+}
+
+static void partialUpdate()
+{
+  // Every character differs from the one written by the last iteration.
+  display.print(iteration & 1 ? "abcdefgh" : "ABCDEFGH");
+}
+
+static void prepareText()
+{
+  fillText();
+  display.display();
+}
+
+static void clear()
+{
+  display.clear();
+}
+
+static void scrollDisplayUp()
+{
+  display.scrollDisplayUp();
+}
+
+static void loadCustomCharacterAndDisplay()
+{
+  display.loadCustomCharacterFromRam(
+    iteration & 1 ? otherCustomChar : customChar, 6);
+  display.display();
+}
+
+struct Benchmark
+{
+  const char * name;
+  void (*setLayout)();
+  void (*prepare)();
+  void (*operation)();
+};
+
+static const Benchmark benchmarks[] = {
+  { "8x2, full update", setLayout8x2, prepareFullUpdate, fullUpdate },
+  { "8x2, partial update, 8 chars", setLayout8x2,
+    preparePartialUpdate, partialUpdate },
+  { "8x2+graphics, full update", setLayout8x2WithGraphics,
+    nullptr, fullUpdate },
+  { "8x2+graphics, partial update, 8 chars", setLayout8x2WithGraphics,
+    preparePartialUpdate, partialUpdate },
+  { "11x4, full update", setLayout11x4, prepareFullUpdate, fullUpdate },
+  { "11x4, partial update, 8 chars", setLayout11x4,
+    preparePartialUpdate, partialUpdate },
+  { "11x4+graphics, full update", setLayout11x4WithGraphics,
+    nullptr, fullUpdate },
+  { "11x4+graphics, partial update, 8 chars", setLayout11x4WithGraphics,
+    preparePartialUpdate, partialUpdate },
+  { "21x8, full update", setLayout21x8, prepareFullUpdate, fullUpdate },
+  { "21x8, partial update, 8 chars", setLayout21x8,
+    preparePartialUpdate, partialUpdate },
+  { "21x8+graphics, full update", setLayout21x8WithGraphics,
+    nullptr, fullUpdate },
+  { "21x8+graphics, partial update, 8 chars", setLayout21x8WithGraphics,
+    preparePartialUpdate, partialUpdate },
+  { "8x2, clear", setLayout8x2, prepareText, clear },
+  { "21x8, clear", setLayout21x8, prepareText, clear },
+  { "8x2, scrollDisplayUp", setLayout8x2, prepareText, scrollDisplayUp },
+  { "21x8, scrollDisplayUp", setLayout21x8, prepareText, scrollDisplayUp },
+  { "8x2, loadCustomCharacter and display", setLayout8x2,
+    nullptr, loadCustomCharacterAndDisplay },
+  { "21x8, loadCustomCharacter and display", setLayout21x8,
+    nullptr, loadCustomCharacterAndDisplay },
+};
+
+static const uint32_t iterations = 2000;
+
+int main()
+{
+  for (uint16_t i = 0; i < sizeof(graphics); i++)
+  {
+    graphics[i] = i * 37 ^ i >> 3;
+  }
+
+  printf("operation,ns_per_op,data_bytes,command_bytes,dc_toggles,transfers\n");
+  for (const Benchmark & b : benchmarks)
+  {
+    b.setLayout();
+    fillText();
+    display.display();  // first display takes extra time clearing RAM
+
+    uint64_t nanoseconds = 0;
+    PololuSH1106BusCounts total = PololuSH1106BusCounts();
+    for (iteration = 0; iteration < iterations; iteration++)
+    {
+      if (b.prepare) { b.prepare(); }
+      display.core.resetCounts();
+      const auto start = std::chrono::steady_clock::now();
+      b.operation();
+      const auto end = std::chrono::steady_clock::now();
+      nanoseconds += std::chrono::duration_cast<
+        std::chrono::nanoseconds>(end - start).count();
+
+      const PololuSH1106BusCounts & counts = display.core.getCounts();
+      total.dataBytes += counts.dataBytes;
+      total.commandBytes += counts.commandBytes;
+      total.dcToggles += counts.dcToggles;
+      total.transfers += counts.transfers;
+    }
+
+    // The counts are averages, in case an operation does not send the same
+    // thing every time.
+    printf("\"%s\",%llu,%.1f,%.1f,%.1f,%.1f\n", b.name,
+      (unsigned long long)(nanoseconds / iterations),
+      (double)total.dataBytes / iterations,
+      (double)total.commandBytes / iterations,
+      (double)total.dcToggles / iterations,
+      (double)total.transfers / iterations);
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+// A minimal stand-in for the Arduino core, so that the library's headers can
+// be compiled and tested on a PC.  It only provides what the library and the
+// tests in this directory use.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+
+#define INPUT 0
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+// The tests can watch the pins by setting digitalWriteHook().
+typedef void (*PinHook)(uint8_t pin, uint8_t value);
+inline PinHook & digitalWriteHook() { static PinHook hook; return hook; }
+inline uint8_t * pinLevels() { static uint8_t levels[256]; return levels; }
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return pinLevels()[pin]; }
+inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+  pinLevels()[pin] = value;
+  if (digitalWriteHook()) { digitalWriteHook()(pin, value); }
+}
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline unsigned long micros()
+{
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000UL + t.tv_nsec / 1000;
+}
+
+inline unsigned long millis() { return micros() / 1000; }
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t * buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--) { n += write(*buffer++); }
+    return n;
+  }
+  virtual void flush() {}
+
+  size_t write(const char * s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const char * s) { return write(s); }
+  size_t print(const __FlashStringHelper * s)
+  {
+    // Like the Arduino core, this writes program space strings one
+    // character at a time.
+    size_t n = 0;
+    for (const char * p = (const char *)s; *p; p++) { n += write((uint8_t)*p); }
+    return n;
+  }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long n) { char b[24]; snprintf(b, sizeof(b), "%ld", n); return write(b); }
+  size_t print(unsigned long n) { char b[24]; snprintf(b, sizeof(b), "%lu", n); return write(b); }
+  size_t print(int n) { return print((long)n); }
+  size_t print(unsigned int n) { return print((unsigned long)n); }
+};
@@ -0,0 +1,48 @@
+// A mock of the Arduino SPI library that records what is sent, for testing
+// PololuSH1106SPICore on a PC.
+
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+struct SPISettings
+{
+  SPISettings(uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST,
+    uint8_t dataMode = SPI_MODE0)
+    : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock;
+  uint8_t bitOrder, dataMode;
+};
+
+class SPIClass
+{
+public:
+  void begin() { begun = true; }
+  void beginTransaction(SPISettings s) { transactions++; depth++; settings = s; }
+  void endTransaction() { depth--; }
+  uint8_t transfer(uint8_t d) { record(d); return 0xFF; }
+  void transfer(void * buffer, size_t size)
+  {
+    uint8_t * p = (uint8_t *)buffer;
+    while (size--) { record(*p); *p++ = 0xFF; }
+  }
+
+  // Each byte sent is recorded with the level of dcPin in bit 8.
+  // misplacedBytes counts the bytes sent outside of a transaction or while
+  // csPin is high.
+  uint8_t dcPin = 255, csPin = 255;
+  bool begun = false;
+  int transactions = 0, depth = 0, misplacedBytes = 0;
+  SPISettings settings;
+  std::vector<uint16_t> sent;
+
+private:
+  void record(uint8_t d)
+  {
+    if (depth != 1 || (csPin != 255 && digitalRead(csPin))) { misplacedBytes++; }
+    sent.push_back(d | (dcPin != 255 && digitalRead(dcPin)) << 8);
+  }
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,376 @@
+// Renders scenes with PololuSH1106Emulator and compares the images to the
+// PBM files in the golden directory.  Run with --update to rewrite the PBM
+// files after an intended change to what the library draws.
+//
+// The Makefile builds this with and without POLOLU_OLED_FAST_DOUBLE_TEXT,
+// and both builds must match the same images.
+
+#include <PololuSH1106Emulator.h>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+extern const PololuOLEDFont proportionalFont;
+extern const PololuOLEDCompressedFont compressedFont;
+
+typedef PololuSH1106Emulator Display;
+
+class StringPrint : public Print
+{
+public:
+  size_t write(uint8_t c) override { text += (char)c; return 1; }
+  std::string text;
+};
+
+static const uint8_t clockwiseChar[] PROGMEM = {
+  0b01110, 0b10001, 0b10101, 0b10101, 0b10111, 0b10000, 0b10001, 0b01110,
+};
+
+static const uint8_t counterClockwiseChar[] PROGMEM = {
+  0b01110, 0b10001, 0b10101, 0b10101, 0b11101, 0b00001, 0b10001, 0b01110,
+};
+
+static uint8_t graphics[1024];
+
+static void drawGraphics()
+{
+  for (uint16_t i = 0; i < sizeof(graphics); i++)
+  {
+    const uint8_t x = i & 127, page = i >> 7;
+    graphics[i] = (x == page * 8 || x == 127 - page * 8) ? 0xFF : 0;
+    if (x >= 56 && x < 72) { graphics[i] |= 0x81; }
+  }
+}
+
+// Fills every line of the text buffer with different characters, including
+// the custom characters 6 and 7, without writing to the display.
+static void fillText(Display & d)
+{
+  d.loadCustomCharacter(clockwiseChar, 6);
+  d.loadCustomCharacter(counterClockwiseChar, 7);
+  d.noAutoDisplay();
+  for (uint8_t y = 0; y < 8; y++)
+  {
+    d.gotoXY(0, y);
+    for (uint8_t x = 0; x < 21; x++)
+    {
+      d.write((uint8_t)(0x21 + (y * 21 + x * 5) % 94));
+    }
+  }
+  d.gotoXY(2, 0);
+  d.print("\6\7");
+  d.gotoXY(1, 1);
+  d.print("\7 \6");
+}
+
+static void layout8x2(Display & d) { fillText(d); d.setLayout8x2(); d.display(); }
+
+static void layout8x2WithGraphics(Display & d)
+{
+  fillText(d);
+  d.setLayout8x2WithGraphics(graphics);
+  d.display();
+}
+
+static void layout11x4(Display & d) { fillText(d); d.setLayout11x4(); d.display(); }
+
+static void layout11x4WithGraphics(Display & d)
+{
+  fillText(d);
+  d.setLayout11x4WithGraphics(graphics);
+  d.display();
+}
+
+static void layout21x8(Display & d) { fillText(d); d.setLayout21x8(); d.display(); }
+
+static void layout21x8WithGraphics(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8WithGraphics(graphics);
+  d.display();
+}
+
+static void drawPage(uint8_t page, uint8_t * strip)
+{
+  memcpy(strip, graphics + page * 128, 128);
+}
+
+static uint8_t strip[128];
+
+static void layout21x8WithGraphicsCallback(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8WithGraphicsCallback(drawPage, strip);
+  d.display();
+}
+
+static void layoutScaled(Display & d) { fillText(d); d.setLayoutScaled(3, 2); d.display(); }
+
+static void layoutScaledWithGraphics(Display & d)
+{
+  fillText(d);
+  d.setLayoutScaledWithGraphics(3, 2, graphics);
+  d.display();
+}
+
+static void layoutTiles(Display & d)
+{
+  static const uint8_t ramTiles[16] = {
+    0x3C, 0x42, 0x81, 0x81, 0x81, 0x81, 0x42, 0x3C,
+    0x3C, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0x3C,
+  };
+  static const PololuSH1106TileSet tileSet = { graphics, ramTiles, 2 };
+  fillText(d);
+  d.setLayoutTiles(&tileSet);
+  d.gotoXY(4, 3);
+  d.write(0);
+  d.write(1);
+  d.display();
+}
+
+static void rotated(Display & d)
+{
+  fillText(d);
+  d.setLayout11x4WithGraphics(graphics);
+  d.rotate180();
+  d.display();
+}
+
+// Writes text in auto display mode, so that only the changed characters are
+// written with partial updates.
+static void partialUpdates(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8();
+  d.display();
+  d.gotoXY(3, 2);
+  d.print("Hello");
+  d.gotoXY(20, 7);
+  d.write('!');
+  d.beginUpdate();
+  d.gotoXY(0, 4);
+  d.print("abc");
+  d.gotoXY(10, 4);
+  d.print("xyz");
+  d.endUpdate();
+  d.noAutoDisplay();
+  d.gotoXY(0, 6);
+  d.print("direct");
+  d.displayPartial(0, 6, 3);
+}
+
+static void partialUpdates8x2WithGraphics(Display & d)
+{
+  fillText(d);
+  d.setLayout8x2WithGraphics(graphics);
+  d.display();
+  d.gotoXY(1, 0);
+  d.print("ab");
+  d.gotoXY(7, 1);
+  d.write('Z');
+}
+
+// Redefines a custom character after it was displayed, which makes
+// display() write the characters that show it again.
+static void customCharacters(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8();
+  d.display();
+  d.loadCustomCharacter(counterClockwiseChar, 6);
+  d.loadCustomCharacter(clockwiseChar, 7);
+  d.display();
+}
+
+static void scrollSoftware(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8();
+  d.display();
+  d.scrollDisplayUp();
+  d.scrollDisplayUp();
+  d.gotoXY(0, 7);
+  d.print("bottom");
+  d.display();
+}
+
+static void scrollHardware(Display & d)
+{
+  d.hardwareScroll();
+  scrollSoftware(d);
+}
+
+// hardwareScroll() has no effect on layouts with graphics.
+static void scrollWithGraphics(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8WithGraphics(graphics);
+  d.display();
+  d.scrollDisplayUp();
+}
+
+static void scrollWithGraphicsInHardwareMode(Display & d)
+{
+  d.hardwareScroll();
+  scrollWithGraphics(d);
+}
+
+static void scroll8x2(Display & d)
+{
+  fillText(d);
+  d.setLayout8x2();
+  d.display();
+  d.scrollDisplayUp();
+}
+
+static void graphicsRect(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8WithGraphics(graphics);
+  d.display();
+  for (uint16_t i = 3 * 128 + 40; i < 3 * 128 + 90; i++) { graphics[i] ^= 0x3C; }
+  d.displayGraphicsRect(44, 24, 40, 8);
+  drawGraphics();
+}
+
+static void shadowBuffer(Display & d)
+{
+  static PololuSH1106ShadowBuffer shadow;
+  fillText(d);
+  d.setLayout21x8WithGraphics(graphics);
+  d.setShadowBuffer(&shadow);
+  d.display();
+  graphics[5 * 128 + 100] = 0x55;
+  d.gotoXY(0, 3);
+  d.print("shadow");
+  d.display();
+  drawGraphics();
+}
+
+static void proportional(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8();
+  d.setFont(&proportionalFont, 0x0F);
+  d.display();
+  d.gotoXY(2, 1);
+  d.print("iii");
+  d.display();
+}
+
+static void compressed(Display & d)
+{
+  fillText(d);
+  d.setLayout21x8WithGraphics(graphics);
+  d.setCompressedFont(&compressedFont, 0xF0);
+  d.display();
+  d.gotoXY(2, 5);
+  d.print("MM");
+  d.display();
+}
+
+static void terminal(Display & d)
+{
+  static PololuSH1106ScrollbackBuffer<4> scrollback;
+  d.setLayout21x8();
+  d.terminalMode();
+  d.setScrollbackBuffer(&scrollback);
+  for (uint8_t i = 0; i < 11; i++)
+  {
+    d.print("line ");
+    d.print(i);
+    d.print("\tx\n");
+  }
+  d.print("abc\bd\rX");
+  d.setScrollbackView(2);
+}
+
+// A scrollback buffer must not be used after noScrollbackBuffer().
+static void terminalWithoutScrollback(Display & d)
+{
+  static PololuSH1106ScrollbackBuffer<1> buffer;
+  d.setLayout21x8();
+  d.terminalMode();
+  d.setScrollbackBuffer(&buffer);
+  d.noScrollbackBuffer();
+  for (uint8_t i = 0; i < 11; i++)
+  {
+    d.print("line ");
+    d.print(i);
+    d.print('\n');
+  }
+}
+
+struct Test
+{
+  const char * name;
+  void (*scene)(Display &);
+};
+
+static const Test tests[] = {
+  { "layout_8x2", layout8x2 },
+  { "layout_8x2_graphics", layout8x2WithGraphics },
+  { "layout_11x4", layout11x4 },
+  { "layout_11x4_graphics", layout11x4WithGraphics },
+  { "layout_21x8", layout21x8 },
+  { "layout_21x8_graphics", layout21x8WithGraphics },
+  { "layout_21x8_graphics", layout21x8WithGraphicsCallback },
+  { "layout_scaled", layoutScaled },
+  { "layout_scaled_graphics", layoutScaledWithGraphics },
+  { "layout_tiles", layoutTiles },
+  { "rotate180", rotated },
+  { "partial", partialUpdates },
+  { "partial_8x2_graphics", partialUpdates8x2WithGraphics },
+  { "custom_characters", customCharacters },
+  { "scroll", scrollSoftware },
+  { "scroll", scrollHardware },
+  { "scroll_graphics", scrollWithGraphics },
+  { "scroll_graphics", scrollWithGraphicsInHardwareMode },
+  { "scroll_8x2", scroll8x2 },
+  { "graphics_rect", graphicsRect },
+  { "shadow_buffer", shadowBuffer },
+  { "font_proportional", proportional },
+  { "font_compressed", compressed },
+  { "terminal", terminal },
+  { "terminal_no_scrollback", terminalWithoutScrollback },
+};
+
+static std::string render(void (*scene)(Display &))
+{
+  drawGraphics();
+  Display * d = new Display();
+  scene(*d);
+  StringPrint image;
+  d->core.dumpPbm(image);
+  delete d;
+  return image.text;
+}
+
+int main(int argc, char ** argv)
+{
+  const bool update = argc > 1 && std::string(argv[1]) == "--update";
+  int failures = 0;
+  std::set<std::string> written;
+  for (const Test & test : tests)
+  {
+    const std::string path = std::string("golden/") + test.name + ".pbm";
+    const std::string image = render(test.scene);
+    if (update && written.insert(path).second)
+    {
+      std::ofstream(path.c_str(), std::ios::binary) << image;
+      continue;
+    }
+    std::ifstream file(path.c_str(), std::ios::binary);
+    std::stringstream golden;
+    golden << file.rdbuf();
+    if (golden.str() != image)
+    {
+      printf("FAIL %s (%s)\n", test.name, path.c_str());
+      failures++;
+    }
+  }
+  const int count = sizeof(tests) / sizeof(tests[0]);
+  printf("%d of %d images match\n", count - failures, count);
+  return failures ? 1 : 0;
+}
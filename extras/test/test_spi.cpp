@@ -0,0 +1,93 @@
+// Checks that PololuSH1106SPI sends the same bytes, in the same modes, as
+// the bit-banged PololuSH1106, using the mock SPI library in host/SPI.h.
+
+#include <PololuOLED.h>
+#include <PololuSH1106SPI.h>
+#include <vector>
+
+SPIClass SPI;
+
+const uint8_t clkPin = 1, mosPin = 2, resPin = 3, dcPin = 4, csPin = 5;
+
+// Decodes what PololuSH1106Core sends by watching its CLK and MOS pins, and
+// records each byte the same way as the mock SPI library.
+static std::vector<uint16_t> bitBangedBytes;
+static int bitBangedMisplacedBits;
+static uint8_t bitCount, shiftRegister, lastClk;
+
+static void watchBitBangedPins(uint8_t pin, uint8_t value)
+{
+  if (pin != clkPin) { return; }
+  if (value && !lastClk)
+  {
+    if (digitalRead(csPin)) { bitBangedMisplacedBits++; }
+    shiftRegister = shiftRegister << 1 | digitalRead(mosPin);
+    if (++bitCount == 8)
+    {
+      bitBangedBytes.push_back(shiftRegister | digitalRead(dcPin) << 8);
+      bitCount = 0;
+    }
+  }
+  lastClk = value;
+}
+
+static uint8_t graphics[1024];
+
+template <class D> static void drawScene(D & d)
+{
+  for (uint16_t i = 0; i < sizeof(graphics); i++) { graphics[i] = i * 37 ^ i >> 3; }
+  d.setContrast(0x40);
+  d.print("Hello");
+  d.gotoXY(1, 1);
+  d.print("SPI");
+  d.setLayout21x8WithGraphics(graphics);
+  d.display();
+  d.gotoXY(4, 3);
+  d.print("partial");
+  d.displayGraphicsRect(10, 10, 30, 20);
+  d.rotate180();
+  d.invert();
+  d.setLayout11x4();
+  d.scrollDisplayUp();
+  d.clear();
+}
+
+static int failures;
+
+static void check(bool condition, const char * description)
+{
+  if (!condition)
+  {
+    printf("FAIL %s\n", description);
+    failures++;
+  }
+}
+
+int main()
+{
+  digitalWriteHook() = watchBitBangedPins;
+  PololuSH1106 * bitBanged = new PololuSH1106(clkPin, mosPin, resPin, dcPin, csPin);
+  drawScene(*bitBanged);
+  delete bitBanged;
+  digitalWriteHook() = nullptr;
+
+  SPI.dcPin = dcPin;
+  SPI.csPin = csPin;
+  PololuSH1106SPI * spi = new PololuSH1106SPI(resPin, dcPin, csPin, 8000000);
+  drawScene(*spi);
+  delete spi;
+
+  check(!bitBangedBytes.empty(), "the bit-banged core sends bytes");
+  check(bitCount == 0, "the bit-banged core sends whole bytes");
+  check(bitBangedMisplacedBits == 0, "the bit-banged core only sends while CS is low");
+  check(SPI.sent == bitBangedBytes, "the SPI core sends the same bytes and DC levels");
+  check(SPI.begun, "the SPI core calls SPI.begin()");
+  check(SPI.misplacedBytes == 0, "the SPI core only sends in a transaction while CS is low");
+  check(SPI.depth == 0, "every SPI transaction is ended");
+  check(SPI.settings.clock == 8000000, "the SPI core uses the clock frequency it was given");
+  check(SPI.settings.bitOrder == MSBFIRST && SPI.settings.dataMode == SPI_MODE0,
+    "the SPI core uses MSB first, mode 0");
+
+  printf("%d bytes compared, %d SPI transactions\n", (int)SPI.sent.size(), SPI.transactions);
+  return failures ? 1 : 0;
+}
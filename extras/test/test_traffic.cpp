@@ -0,0 +1,398 @@
+// Checks what the library sends to the display in some cases where the
+// image alone does not show whether it works, by counting the bytes and
+// transfers with PololuSH1106CountingCore.
+
+#include <PololuSH1106Counting.h>
+#include <PololuSH1106Emulator.h>
+#include <PololuSH1106Multi.h>
+
+extern const PololuOLEDFont proportionalFont;
+
+typedef PololuSH1106CountingCore<PololuSH1106EmulatorCore> CountingEmulatorCore;
+typedef PololuSH1106Main<CountingEmulatorCore> Display;
+typedef PololuSH1106Main<PololuSH1106CountingCore<PololuSH1106BusyEmulatorCore>>
+  BusyDisplay;
+
+static int failures;
+
+static void check(bool condition, const char * description)
+{
+  if (!condition)
+  {
+    printf("FAIL %s\n", description);
+    failures++;
+  }
+}
+
+template <class D> static bool sameImage(const D & a, const Display & b)
+{
+  for (uint8_t y = 0; y < 64; y++)
+  {
+    for (uint8_t x = 0; x < 128; x++)
+    {
+      if (a.core.getPixel(x, y) != b.core.getPixel(x, y)) { return false; }
+    }
+  }
+  return true;
+}
+
+template <class D> static void fillText(D & d)
+{
+  d.noAutoDisplay();
+  for (uint8_t y = 0; y < 8; y++)
+  {
+    d.gotoXY(0, y);
+    for (uint8_t x = 0; x < 21; x++) { d.write((uint8_t)('A' + (x + y) % 26)); }
+  }
+}
+
+// In hardwareScroll() mode, scrolling must not change the OLED until the
+// text is written.
+static void testHardwareScrollWaitsForDisplay()
+{
+  Display * hardware = new Display();
+  Display * software = new Display();
+  Display * const displays[] = { hardware, software };
+  hardware->hardwareScroll();
+  for (Display * d : displays)
+  {
+    d->setLayout21x8();
+    fillText(*d);
+    d->display();
+    d->noAutoDisplay();
+    d->core.resetCounts();
+    d->scrollDisplayUp();
+  }
+  check(hardware->core.getCounts().transfers == 0,
+    "scrollDisplayUp() sends nothing in noAutoDisplay() mode");
+
+  hardware->display();
+  software->display();
+  check(hardware->core.getCounts().transfers == 1,
+    "display() sends the start line and the bottom line in one transfer");
+  check(sameImage(*hardware, *software),
+    "scrolling in hardware and software gives the same image");
+
+  hardware->beginUpdate();
+  hardware->scrollDisplayUp();
+  check(hardware->core.getCounts().transfers == 1,
+    "scrollDisplayUp() sends nothing between beginUpdate() and endUpdate()");
+  hardware->endUpdate();
+
+  delete hardware;
+  delete software;
+}
+
+// display() writes all the dirty text in one transfer, even when it is
+// spread over several lines.
+static void testDirtyTextInOneTransfer()
+{
+  Display * d = new Display();
+  d->setLayout21x8();
+  fillText(*d);
+  d->display();
+  d->noAutoDisplay();
+  d->gotoXY(2, 1);
+  d->print("ab");
+  d->gotoXY(10, 1);
+  d->print("cd");
+  d->gotoXY(5, 6);
+  d->print("ef");
+  d->core.resetCounts();
+  d->display();
+  check(d->core.getCounts().transfers == 1,
+    "display() writes several dirty runs in one transfer");
+  check(d->core.getCounts().dataBytes == 6 * 6,
+    "display() only writes the dirty characters");
+  delete d;
+}
+
+// A line that uses a proportional font is rewritten from the first changed
+// character to the right edge, so display() writes it once even when several
+// separate characters changed.
+static void testProportionalLineWrittenOnce()
+{
+  Display * d = new Display();
+  Display * fresh = new Display();
+  Display * const displays[] = { d, fresh };
+  for (Display * e : displays)
+  {
+    e->setLayout21x8();
+    e->setFont(&proportionalFont, 0x02);
+    fillText(*e);
+  }
+  d->display();
+  d->noAutoDisplay();
+  d->gotoXY(2, 1);
+  d->write('i');
+  d->gotoXY(8, 1);
+  d->write('W');
+  d->gotoXY(15, 1);
+  d->write('.');
+  fresh->gotoXY(2, 1);
+  fresh->write('i');
+  fresh->gotoXY(8, 1);
+  fresh->write('W');
+  fresh->gotoXY(15, 1);
+  fresh->write('.');
+  fresh->display();
+  d->core.resetCounts();
+  d->display();
+  check(d->core.getCounts().dataBytes > 0 && d->core.getCounts().dataBytes <= 128,
+    "display() writes a proportional font line at most once");
+  check(sameImage(*d, *fresh),
+    "changing a proportional font line gives the same image as drawing it");
+  delete d;
+  delete fresh;
+}
+
+// In skipUnchangedPages() mode, display() only writes the pages whose
+// graphics or text changed.
+static void testSkipUnchangedPages()
+{
+  static uint8_t graphics[1024];
+  static uint16_t signatures[8];
+  Display * d = new Display();
+  Display * fresh = new Display();
+  Display * const displays[] = { d, fresh };
+  for (Display * e : displays)
+  {
+    e->setLayout21x8WithGraphics(graphics);
+    fillText(*e);
+  }
+  d->skipUnchangedPages(signatures);
+  d->display();
+  d->core.resetCounts();
+  d->display();
+  check(d->core.getCounts().dataBytes == 0,
+    "display() skips every page when nothing changed");
+
+  graphics[5 * 128 + 60] = 0x18;
+  for (Display * e : displays)
+  {
+    e->noAutoDisplay();
+    e->gotoXY(3, 2);
+    e->write('!');
+  }
+  d->core.resetCounts();
+  d->display();
+  check(d->core.getCounts().dataBytes == 2 * 128,
+    "display() only writes the pages that changed");
+  fresh->display();
+  check(sameImage(*d, *fresh),
+    "skipping unchanged pages gives the same image as writing them all");
+  delete d;
+  delete fresh;
+}
+
+static int graphicsCallbacks;
+
+static void countGraphicsCallback(uint8_t page, uint8_t * strip)
+{
+  graphicsCallbacks++;
+  for (uint8_t x = 0; x < 128; x++) { strip[x] = x * (page + 1); }
+}
+
+// With a shadow buffer, display() runs the graphics callback once per page.
+static void testShadowBufferCallbackOncePerPage()
+{
+  static uint8_t strip[128];
+  static PololuSH1106ShadowBuffer shadow;
+  Display * d = new Display();
+  d->setLayout21x8WithGraphicsCallback(countGraphicsCallback, strip);
+  d->setShadowBuffer(&shadow);
+  d->display();
+  graphicsCallbacks = 0;
+  d->display();
+  check(graphicsCallbacks == 8,
+    "display() with a shadow buffer calls the graphics callback once per page");
+
+  static uint8_t plainStrip[128];
+  Display * plain = new Display();
+  plain->setLayout21x8WithGraphicsCallback(countGraphicsCallback, plainStrip);
+  plain->display();
+  check(sameImage(*d, *plain), "a shadow buffer does not change the image");
+  delete d;
+  delete plain;
+}
+
+static uint8_t asyncGraphics[1024];
+static int asyncCallbacks;
+
+static void countAsyncCallback()
+{
+  asyncCallbacks++;
+}
+
+// displayAsync() with a core that sends in the background writes the screen
+// one part at a time as isBusy() is polled, never calls the core while it is
+// busy, and ends with the same image as display().
+template <class Setup> static void testDisplayAsync(Setup setup, int minimumParts,
+  const char * layout)
+{
+  BusyDisplay * async = new BusyDisplay();
+  Display * blocking = new Display();
+  setup(*async);
+  setup(*blocking);
+  fillText(*async);
+  fillText(*blocking);
+  blocking->display();
+
+  asyncCallbacks = 0;
+  async->displayAsync(countAsyncCallback);
+  int polls = 1;
+  while (async->isBusy() && polls < 10000) { polls++; }
+
+  printf("%s: %d polls, %d transfers\n", layout, polls,
+    (int)async->core.getCounts().transfers);
+  check(polls > 1, "displayAsync() returns before the update is done");
+  check(!async->isBusy(), "isBusy() returns false when the update is done");
+  check((int)async->core.getCounts().transfers >= minimumParts,
+    "displayAsync() writes the screen in parts");
+  check(asyncCallbacks == 1, "the displayAsync() callback is called once");
+  check(async->core.getBusyViolations() == 0,
+    "the core is not called while it is busy");
+  check(sameImage(*async, *blocking), "displayAsync() draws the same as display()");
+  delete async;
+  delete blocking;
+}
+
+struct SetLayout21x8WithGraphics
+{
+  template <class D> void operator()(D & d)
+  {
+    for (uint16_t i = 0; i < sizeof(asyncGraphics); i++) { asyncGraphics[i] = i * 37; }
+    d.setLayout21x8WithGraphics(asyncGraphics);
+  }
+};
+
+struct SetLayout11x4
+{
+  template <class D> void operator()(D & d) { d.setLayout11x4(); }
+};
+
+static bool sameCounts(const PololuSH1106BusCounts & a,
+  const PololuSH1106BusCounts & b)
+{
+  return a.dataBytes == b.dataBytes && a.commandBytes == b.commandBytes &&
+    a.dcToggles == b.dcToggles && a.transfers == b.transfers;
+}
+
+// A display with a fixed layout does not store the layout state, and sends
+// the same bytes as a display that selects the layout at run time.
+template <class Layout, class Setup> static void testFixedLayout(Setup setup)
+{
+  typedef PololuSH1106Fixed<CountingEmulatorCore, Layout> Fixed;
+  static_assert(sizeof(Fixed) < sizeof(PololuSH1106Main<CountingEmulatorCore,
+    Layout::width, Layout::height>), "a fixed layout is not stored");
+
+  Fixed * fixed = new Fixed();
+  Display * runtime = new Display();
+  setup(*fixed);
+  setup(*runtime);
+  fillText(*fixed);
+  fillText(*runtime);
+  fixed->display();
+  runtime->display();
+  check(sameCounts(fixed->core.getCounts(), runtime->core.getCounts()),
+    "display() with a fixed layout sends the same bytes");
+
+  fixed->core.resetCounts();
+  runtime->core.resetCounts();
+  fixed->gotoXY(1, 1);
+  runtime->gotoXY(1, 1);
+  fixed->print("xyz");
+  runtime->print("xyz");
+  check(sameCounts(fixed->core.getCounts(), runtime->core.getCounts()),
+    "a partial update with a fixed layout sends the same bytes");
+  check(sameImage(*fixed, *runtime), "a fixed layout gives the same image");
+  delete fixed;
+  delete runtime;
+}
+
+struct SetLayout8x2
+{
+  template <class D> void operator()(D & d) { d.setLayout8x2(); }
+};
+
+struct SetLayout8x2WithGraphics
+{
+  template <class D> void operator()(D & d)
+  {
+    for (uint16_t i = 0; i < sizeof(asyncGraphics); i++) { asyncGraphics[i] = i * 37; }
+    d.setLayout8x2WithGraphics(asyncGraphics);
+  }
+};
+
+struct SetLayout11x4WithGraphics
+{
+  template <class D> void operator()(D & d)
+  {
+    for (uint16_t i = 0; i < sizeof(asyncGraphics); i++) { asyncGraphics[i] = i * 37; }
+    d.setLayout11x4WithGraphics(asyncGraphics);
+  }
+};
+
+struct SetLayout21x8
+{
+  template <class D> void operator()(D & d) { d.setLayout21x8(); }
+};
+
+// The displays of a PololuSH1106Multi share one custom character table, and
+// redefining a character updates every display that shows it.
+static void testMultiSharedCustomChars()
+{
+  static const uint8_t before[] = { 1, 2, 4, 8, 16, 8, 4, 2 };
+  static const uint8_t after[] = { 31, 17, 17, 17, 17, 17, 17, 31 };
+  typedef PololuSH1106Multi<CountingEmulatorCore, 2> Multi;
+  static_assert(sizeof(Multi) < 2 * sizeof(Display),
+    "the custom characters are not stored for each display");
+
+  Multi * multi = new Multi();
+  Display * reference = new Display();
+  multi->loadCustomCharacterFromRam(before, 3);
+  reference->loadCustomCharacterFromRam(before, 3);
+  reference->setLayout21x8();
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    (*multi)[i].setLayout21x8();
+    (*multi)[i].gotoXY(i, 2);
+    (*multi)[i].write(3);
+  }
+  multi->display();
+
+  multi->loadCustomCharacterFromRam(after, 3);
+  reference->loadCustomCharacterFromRam(after, 3);
+  multi->display();
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    reference->clear();
+    reference->gotoXY(i, 2);
+    reference->write(3);
+    reference->display();
+    check(sameImage((*multi)[i], *reference),
+      "a shared custom character is redrawn on every display");
+  }
+  delete multi;
+  delete reference;
+}
+
+int main()
+{
+  testHardwareScrollWaitsForDisplay();
+  testDirtyTextInOneTransfer();
+  testProportionalLineWrittenOnce();
+  testSkipUnchangedPages();
+  testShadowBufferCallbackOncePerPage();
+  testDisplayAsync(SetLayout21x8WithGraphics(), 8, "21x8+graphics displayAsync");
+  testDisplayAsync(SetLayout11x4(), 4, "11x4 displayAsync");
+  testFixedLayout<PololuSH1106Layout8x2>(SetLayout8x2());
+  testFixedLayout<PololuSH1106Layout8x2>(SetLayout8x2WithGraphics());
+  testFixedLayout<PololuSH1106Layout11x4>(SetLayout11x4());
+  testFixedLayout<PololuSH1106Layout11x4>(SetLayout11x4WithGraphics());
+  testFixedLayout<PololuSH1106Layout21x8>(SetLayout21x8());
+  testFixedLayout<PololuSH1106Layout21x8>(SetLayout21x8WithGraphics());
+  testMultiSharedCustomChars();
+  if (failures == 0) { printf("all traffic checks passed\n"); }
+  return failures ? 1 : 0;
+}
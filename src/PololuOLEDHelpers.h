@@ -12,6 +12,86 @@
 /// definition in your own program if you want to override the default font.
 extern const PROGMEM uint8_t pololuOledFont[][5] ;
 
+/// @brief Describes a proportional font that can be used instead of
+/// pololuOledFont (see PololuSH1106Main::setFont()).
+///
+/// The tables are in program space, so several display objects can share a
+/// font without using any more memory.  The descriptor itself is small and
+/// can be stored in RAM.
+struct PololuOLEDFont
+{
+  /// The code of the first character in the font.
+  uint8_t firstChar;
+
+  /// The code of the last character in the font.
+  uint8_t lastChar;
+
+  /// The number of blank columns drawn after each glyph.
+  uint8_t spacing;
+
+  /// The width of each glyph, in columns (lastChar - firstChar + 1 entries,
+  /// in program space).
+  const uint8_t * widths;
+
+  /// The index in #columns of the first column of each glyph
+  /// (lastChar - firstChar + 1 entries, in program space).
+  const uint16_t * offsets;
+
+  /// The columns of all the glyphs, in program space.  Each byte represents a
+  /// 1x8 vertical column of pixels, with the least-significant bit holding the
+  /// top-most pixel.
+  const uint8_t * columns;
+};
+
+/// @brief Describes a fixed-width font stored in a compressed format (see
+/// PololuSH1106Main::setCompressedFont()).
+///
+/// You can generate one of these from an X BitMap font like the one in the
+/// CustomFont example with extras/compress_font.py.
+///
+/// The columns of the glyphs are stored as a stream of 4-bit codes in
+/// #codes, with the low nibble of each byte first.  Each column is one of:
+///
+/// - A code n less than #shortCodes: the column is dictionary[n].
+/// - A code n from #shortCodes to 14 followed by a code m: the column is
+///   dictionary[shortCodes + (n - shortCodes) * 16 + m].
+/// - A code 15 followed by two codes: the column itself, low nibble first.
+///
+/// The converter puts the columns that are used most often in the
+/// dictionary, so most columns take one or two codes instead of a byte.
+struct PololuOLEDCompressedFont
+{
+  /// The code of the first character in the font.
+  uint8_t firstChar;
+
+  /// The code of the last character in the font.
+  uint8_t lastChar;
+
+  /// The width of every glyph, in columns.
+  uint8_t width;
+
+  /// The number of blank columns drawn after each glyph.
+  uint8_t spacing;
+
+  /// The number of dictionary entries that have one-code encodings.
+  uint8_t shortCodes;
+
+  /// #groupOffsets has an entry for every (1 << groupShift)th glyph.
+  uint8_t groupShift;
+
+  /// The most common columns, in program space.
+  const uint8_t * dictionary;
+
+  /// The position in #codes, in nibbles, of the first column of every
+  /// (1 << groupShift)th glyph, in program space.  The glyphs in between are
+  /// found by skipping over the columns before them, so a smaller groupShift
+  /// makes drawing faster but the font bigger.
+  const uint16_t * groupOffsets;
+
+  /// The encoded columns of all the glyphs, in program space.
+  const uint8_t * codes;
+};
+
 namespace PololuOLEDHelpers {
 
 /// @cond
@@ -40,6 +120,193 @@ static inline uint8_t repeatBits(uint8_t d)
   return pgm_read_byte(repeatBitsTable + d);
 }
 
+// Returns d with every bit repeated twice.  This is used to draw
+// double-size glyphs: the lower byte of the result holds the top half of the
+// column and the upper byte holds the bottom half.
+constexpr uint16_t doubleBits(uint8_t d)
+{
+  return (d & 0x01 ? 0x0003 : 0) | (d & 0x02 ? 0x000C : 0) |
+    (d & 0x04 ? 0x0030 : 0) | (d & 0x08 ? 0x00C0 : 0) |
+    (d & 0x10 ? 0x0300 : 0) | (d & 0x20 ? 0x0C00 : 0) |
+    (d & 0x40 ? 0x3000 : 0) | (d & 0x80 ? 0xC000 : 0);
+}
+
+template<uint16_t... I> struct IndexList { };
+
+template<uint16_t N, uint16_t... I> struct MakeIndexList
+  : MakeIndexList<N - 1, N - 1, I...> { };
+
+template<uint16_t... I> struct MakeIndexList<0, I...>
+{
+  typedef IndexList<I...> type;
+};
+
+// A 512-byte table in program space holding doubleBits() of every byte,
+// generated at compile time.  Since it is a static member of a class template,
+// it only takes up space in programs that use it.
+template<class L> struct DoubleBitsTable;
+
+template<uint16_t... I> struct DoubleBitsTable<IndexList<I...>>
+{
+  static const uint16_t table[sizeof...(I)];
+};
+
+template<uint16_t... I> const uint16_t
+  DoubleBitsTable<IndexList<I...>>::table[sizeof...(I)] PROGMEM =
+  { doubleBits(I)... };
+
+static inline uint16_t doubleBitsFromTable(uint8_t d)
+{
+  return pgm_read_word(
+    &DoubleBitsTable<MakeIndexList<256>::type>::table[d]);
+}
+
+// Updates a CRC-16/XMODEM checksum (polynomial 0x1021) with one byte.
+static inline uint16_t crc16Update(uint16_t crc, uint8_t d)
+{
+  crc = (crc >> 8) | (crc << 8);
+  crc ^= d;
+  crc ^= (crc & 0xFF) >> 4;
+  crc ^= crc << 12;
+  crc ^= (crc & 0xFF) << 5;
+  return crc;
+}
+
+// Converts a custom character from 8 rows of 5 pixels, as passed to
+// loadCustomCharacterFromRam(), into 5 columns of 8 pixels, the way the
+// glyphs are sent to the display.
+static inline void customCharacterColumns(const uint8_t * picture,
+  uint8_t * columns)
+{
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    columns[i] = 0;
+  }
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    uint8_t row = picture[i];
+    uint8_t mask = 1 << i;
+    if (row & (1 << 0)) { columns[4] |= mask; }
+    if (row & (1 << 1)) { columns[3] |= mask; }
+    if (row & (1 << 2)) { columns[2] |= mask; }
+    if (row & (1 << 3)) { columns[1] |= mask; }
+    if (row & (1 << 4)) { columns[0] |= mask; }
+  }
+}
+
+// Calls the displayStep() function of the specified object repeatedly, for
+// as long as the slowest step so far would still finish within the time
+// budget.  It is always called at least once.  This is used by the
+// displayFor() functions.
+template<class T> bool displayStepsFor(T & target, uint32_t budgetMicros)
+{
+  const uint32_t start = micros();
+  uint32_t slowestStep = 0;
+  uint32_t elapsed = 0;
+  while (true)
+  {
+    if (target.displayStep()) { return true; }
+    const uint32_t now = micros() - start;
+    if (now - elapsed > slowestStep) { slowestStep = now - elapsed; }
+    elapsed = now;
+    if (elapsed + slowestStep > budgetMicros) { return false; }
+  }
+}
+
+// The templates below let PololuSH1106Main detect, at compile time, whether
+// its core class implements one of the optional core functions.
+
+template<bool b> struct BoolConstant { static const bool value = b; };
+
+// IsSame<A, B>::value is true if A and B are the same type.
+template<class A, class B> struct IsSame : BoolConstant<false> { };
+template<class A> struct IsSame<A, A> : BoolConstant<true> { };
+
+// Conditional<b, T, F>::type is T if b is true, or F otherwise.
+template<bool b, class T, class F> struct Conditional { typedef T type; };
+template<class T, class F> struct Conditional<false, T, F>
+{
+  typedef F type;
+};
+
+template<class T> T & declareReference();
+
+template<class C> class HasWriteBuffer
+{
+  template<class T, class = decltype(declareReference<T>().sh1106WriteBuffer(
+    (const uint8_t *)0, (uint16_t)0))>
+  static char test(int);
+  template<class T> static long test(...);
+public:
+  static const bool value = sizeof(test<C>(0)) == 1;
+};
+
+template<class C> class HasWriteBufferFromProgmem
+{
+  template<class T, class = decltype(declareReference<T>().sh1106WriteBufferFromProgmem(
+    (const uint8_t *)0, (uint16_t)0))>
+  static char test(int);
+  template<class T> static long test(...);
+public:
+  static const bool value = sizeof(test<C>(0)) == 1;
+};
+
+template<class C> class HasBusy
+{
+  template<class T, class = decltype(declareReference<T>().sh1106Busy())>
+  static char test(int);
+  template<class T> static long test(...);
+public:
+  static const bool value = sizeof(test<C>(0)) == 1;
+};
+
+template<class C> class HasRunCost
+{
+  template<class T, class = decltype(declareReference<T>().sh1106RunCost())>
+  static char test(int);
+  template<class T> static long test(...);
+public:
+  static const bool value = sizeof(test<C>(0)) == 1;
+};
+
+// Disables interrupts while it exists, and then puts the interrupt state back
+// the way it was, so it can also be used where interrupts are already
+// disabled (for example, in an interrupt service routine).  On architectures
+// where we do not know how to read the interrupt state, it falls back to
+// noInterrupts() and interrupts(), so interrupts are always enabled
+// afterwards.
+class InterruptGuard
+{
+public:
+#if defined(__AVR__)
+  InterruptGuard() : sreg(SREG) { cli(); }
+  ~InterruptGuard()
+  {
+    SREG = sreg;
+    __asm__ volatile("" ::: "memory");
+  }
+private:
+  uint8_t sreg;
+#elif defined(__arm__) && defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+  InterruptGuard()
+  {
+    __asm__ volatile("mrs %0, primask" : "=r" (primask));
+    __asm__ volatile("cpsid i" ::: "memory");
+  }
+  ~InterruptGuard()
+  {
+    __asm__ volatile("msr primask, %0" : : "r" (primask) : "memory");
+  }
+private:
+  uint32_t primask;
+#else
+  InterruptGuard() { noInterrupts(); }
+  ~InterruptGuard() { interrupts(); }
+#endif
+  InterruptGuard(const InterruptGuard &) = delete;
+  InterruptGuard & operator=(const InterruptGuard &) = delete;
+};
+
 /// @endcond
 
 
@@ -16,7 +16,9 @@
 /// ideal performance.  In 8x2 text+graphics mode on an ATmega32U4 running
 /// at 16 MHz, updating the full screen takes about 110 ms.  You can speed this
 /// up by about 15 times by using an optimized class that directly writes to
-/// specific I/O registers instead of using this class.
+/// specific I/O registers instead of using this class.  If the OLED is
+/// connected to your board's hardware SPI pins, you can also use
+/// PololuSH1106SPICore (from PololuSH1106SPI.h).
 class PololuSH1106Core
 {
 public:
@@ -0,0 +1,220 @@
+// Copyright (C) Pololu Corporation.  See www.pololu.com for details.
+
+/// @file PololuSH1106Canvas.h
+///
+/// This file is not included by PololuOLED.h because it requires the
+/// Adafruit GFX Library.  Include it directly if you want to use
+/// PololuSH1106Canvas.
+
+#pragma once
+
+#include <Adafruit_GFX.h>
+
+#define POLOLU_SH1106_BLACK 0
+#define POLOLU_SH1106_WHITE 1
+#define POLOLU_SH1106_INVERSE 2
+
+/// @brief A 128x64 graphics buffer that you can draw on with the Adafruit GFX
+/// Library and that remembers which parts of it changed.
+///
+/// Pass getBuffer() to one of the setLayoutXxxWithGraphics() functions of
+/// PololuSH1106Main, draw with any of the Adafruit_GFX functions, and then
+/// call display() to write just the columns of each page that were drawn on
+/// since the last call, for example:
+///
+/// ```{.cpp}
+/// PololuSH1106 display(1, 30, 0, 17, 13);
+/// PololuSH1106Canvas canvas;
+///
+/// void setup()
+/// {
+///   display.setLayout8x2WithGraphics(canvas.getBuffer());
+/// }
+///
+/// void loop()
+/// {
+///   canvas.drawLine(0, 0, random(128), random(64), POLOLU_SH1106_INVERSE);
+///   canvas.display(display);
+/// }
+/// ```
+///
+/// Colors work like they do in the Adafruit SSD1306 library:
+/// POLOLU_SH1106_BLACK (0) clears pixels, POLOLU_SH1106_WHITE (1) sets them,
+/// and POLOLU_SH1106_INVERSE (2) inverts them.  Any other color also inverts
+/// them.
+///
+/// The buffer is a member of this class, so unlike Adafruit_SSD1306, it does
+/// not need to be allocated with malloc().
+class PololuSH1106Canvas : public Adafruit_GFX
+{
+public:
+  PololuSH1106Canvas() : Adafruit_GFX(128, 64)
+  {
+    memset(buffer, 0, sizeof(buffer));
+    for (uint8_t page = 0; page < 8; page++) { markClean(page); }
+  }
+
+  /// @brief Returns a pointer to the 1024-byte graphics buffer.
+  ///
+  /// If you change the buffer directly instead of with the drawing
+  /// functions, call markDirty() so that display() writes your changes.
+  uint8_t * getBuffer() { return buffer; }
+
+  /// @brief Writes the parts of the buffer that changed since the last call
+  /// to the display.
+  ///
+  /// @param oled The PololuSH1106Main object that is using this buffer.
+  ///
+  /// This calls PololuSH1106Main::displayGraphicsRect() for each page that
+  /// changed, covering only the columns that changed, so it does not write
+  /// changes to the text.  Call the display() function of the
+  /// PololuSH1106Main object instead if the text changed too (which also
+  /// writes the whole buffer).
+  template <class D> void display(D & oled)
+  {
+    for (uint8_t page = 0; page < 8; page++)
+    {
+      if (dirtyLeft[page] < dirtyRight[page])
+      {
+        oled.displayGraphicsRect(dirtyLeft[page], page * 8,
+          dirtyRight[page] - dirtyLeft[page], 8);
+        markClean(page);
+      }
+    }
+  }
+
+  /// @brief Marks a rectangle of the buffer as changed, so the next call to
+  /// display() writes it.
+  ///
+  /// The coordinates are in pixels, without rotation.
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > 128) { w = 128 - x; }
+    if (y + h > 64) { h = 64 - y; }
+    if (w <= 0 || h <= 0) { return; }
+    for (uint8_t page = y >> 3; page <= (y + h - 1) >> 3; page++)
+    {
+      markDirtyColumns(page, x, x + w);
+    }
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    switch (getRotation())
+    {
+    case 1: { int16_t t = x; x = WIDTH - 1 - y; y = t; } break;
+    case 2: x = WIDTH - 1 - x; y = HEIGHT - 1 - y; break;
+    case 3: { int16_t t = x; x = y; y = HEIGHT - 1 - t; } break;
+    }
+    drawRawHLine(x, y, 1, color);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+  {
+    if (w < 0) { x += w + 1; w = -w; }
+    switch (getRotation())
+    {
+    case 0: drawRawHLine(x, y, w, color); break;
+    case 1: drawRawVLine(WIDTH - 1 - y, x, w, color); break;
+    case 2: drawRawHLine(WIDTH - x - w, HEIGHT - 1 - y, w, color); break;
+    case 3: drawRawVLine(y, HEIGHT - x - w, w, color); break;
+    }
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+  {
+    if (h < 0) { y += h + 1; h = -h; }
+    switch (getRotation())
+    {
+    case 0: drawRawVLine(x, y, h, color); break;
+    case 1: drawRawHLine(WIDTH - y - h, x, h, color); break;
+    case 2: drawRawVLine(WIDTH - 1 - x, HEIGHT - y - h, h, color); break;
+    case 3: drawRawHLine(y, HEIGHT - 1 - x, h, color); break;
+    }
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+    uint16_t color) override
+  {
+    if (w < 0) { x += w + 1; w = -w; }
+    for (int16_t i = 0; i < w; i++) { drawFastVLine(x + i, y, h, color); }
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    for (uint16_t i = 0; i < sizeof(buffer); i++)
+    {
+      buffer[i] = applyColor(buffer[i], 0xFF, color);
+    }
+    markDirty(0, 0, 128, 64);
+  }
+
+private:
+
+  static uint8_t applyColor(uint8_t d, uint8_t mask, uint16_t color)
+  {
+    switch (color)
+    {
+    case 0: return d & ~mask;
+    case 1: return d | mask;
+    default: return d ^ mask;
+    }
+  }
+
+  void drawRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    if (y < 0 || y >= 64) { return; }
+    if (x < 0) { w += x; x = 0; }
+    if (x + w > 128) { w = 128 - x; }
+    if (w <= 0) { return; }
+
+    const uint8_t page = y >> 3;
+    const uint8_t mask = 1 << (y & 7);
+    uint8_t * p = buffer + page * 128 + x;
+    for (int16_t i = 0; i < w; i++, p++) { *p = applyColor(*p, mask, color); }
+    markDirtyColumns(page, x, x + w);
+  }
+
+  void drawRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    if (x < 0 || x >= 128) { return; }
+    if (y < 0) { h += y; y = 0; }
+    if (y + h > 64) { h = 64 - y; }
+    if (h <= 0) { return; }
+
+    while (h > 0)
+    {
+      const uint8_t page = y >> 3;
+      const uint8_t top = y & 7;
+      const uint8_t count = h < 8 - top ? h : 8 - top;
+      const uint8_t mask = (uint8_t)(0xFF << top) & (0xFF >> (8 - top - count));
+      uint8_t * p = buffer + page * 128 + x;
+      *p = applyColor(*p, mask, color);
+      markDirtyColumns(page, x, x + 1);
+      y += count;
+      h -= count;
+    }
+  }
+
+  void markDirtyColumns(uint8_t page, uint8_t left, uint8_t right)
+  {
+    if (left < dirtyLeft[page]) { dirtyLeft[page] = left; }
+    if (right > dirtyRight[page]) { dirtyRight[page] = right; }
+  }
+
+  void markClean(uint8_t page)
+  {
+    dirtyLeft[page] = 128;
+    dirtyRight[page] = 0;
+  }
+
+  uint8_t buffer[1024];
+
+  // The columns of each page that changed since the last call to display(),
+  // from dirtyLeft up to (but not including) dirtyRight.  The page is clean
+  // if dirtyLeft >= dirtyRight.
+  uint8_t dirtyLeft[8];
+  uint8_t dirtyRight[8];
+};
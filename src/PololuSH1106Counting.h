@@ -0,0 +1,136 @@
+// Copyright (C) Pololu Corporation.  See www.pololu.com for details.
+
+/// @file PololuSH1106Counting.h
+///
+/// This file is not included by PololuOLED.h.  Include it directly if you want
+/// to use PololuSH1106CountingCore.
+
+#pragma once
+
+#include "PololuSH1106Main.h"
+
+/// @brief Numbers of bytes and events counted by PololuSH1106CountingCore.
+struct PololuSH1106BusCounts
+{
+  /// The number of data bytes written to the SH1106.
+  uint32_t dataBytes;
+
+  /// The number of command bytes written to the SH1106.
+  uint32_t commandBytes;
+
+  /// The number of times the SH1106 was switched between command mode and
+  /// data mode (i.e. the number of times the DC pin changed).
+  uint32_t dcToggles;
+
+  /// The number of transfers (calls to sh1106TransferStart()).
+  uint32_t transfers;
+};
+
+/// @brief Core class that counts the traffic sent by another core class.
+///
+/// This is a core class for use as the template parameter for PololuSH1106Main.
+/// It passes everything to the core class C, which it derives from, while
+/// counting the data bytes, command bytes, DC changes, and transfers.  This
+/// lets you measure how much work an operation costs on the SH1106 bus, for
+/// example:
+///
+/// ```{.cpp}
+/// PololuSH1106Main<PololuSH1106CountingCore<PololuSH1106Core>> display;
+///
+/// void setup()
+/// {
+///   display.core.setPins(1, 30, 0, 17, 13);
+/// }
+/// ```
+///
+/// If C provides the optional sh1106WriteBuffer() or
+/// sh1106WriteBufferFromProgmem() functions, so does this class, so the
+/// counted traffic is the same as without it.
+template <class C> class PololuSH1106CountingCore : public C
+{
+public:
+  /// @brief Returns the counts accumulated since the last call to
+  /// resetCounts().
+  const PololuSH1106BusCounts & getCounts() const
+  {
+    return counts;
+  }
+
+  /// @brief Sets all of the counts to zero.
+  void resetCounts()
+  {
+    counts = PololuSH1106BusCounts();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to start a data
+  /// transfer to the SH1106.
+  void sh1106TransferStart()
+  {
+    counts.transfers++;
+    C::sh1106TransferStart();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are command bytes.
+  void sh1106CommandMode()
+  {
+    if (dataMode) { counts.dcToggles++; }
+    dataMode = false;
+    C::sh1106CommandMode();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are data bytes.
+  void sh1106DataMode()
+  {
+    if (!dataMode) { counts.dcToggles++; }
+    dataMode = true;
+    C::sh1106DataMode();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write commands or
+  /// data to the SH1106.
+  void sh1106Write(uint8_t d)
+  {
+    count(1);
+    C::sh1106Write(d);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write a run of
+  /// data bytes to the SH1106, if C supports it.
+  template <class D = C, class = decltype(
+    PololuOLEDHelpers::declareReference<D>().sh1106WriteBuffer(
+      (const uint8_t *)0, (uint16_t)0))>
+  void sh1106WriteBuffer(const uint8_t * data, uint16_t length)
+  {
+    count(length);
+    C::sh1106WriteBuffer(data, length);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write a run of
+  /// data bytes from program space to the SH1106, if C supports it.
+  template <class D = C, class = decltype(
+    PololuOLEDHelpers::declareReference<D>().sh1106WriteBufferFromProgmem(
+      (const uint8_t *)0, (uint16_t)0))>
+  void sh1106WriteBufferFromProgmem(const uint8_t * data, uint16_t length)
+  {
+    count(length);
+    C::sh1106WriteBufferFromProgmem(data, length);
+  }
+
+private:
+  void count(uint16_t length)
+  {
+    if (dataMode)
+    {
+      counts.dataBytes += length;
+    }
+    else
+    {
+      counts.commandBytes += length;
+    }
+  }
+
+  PololuSH1106BusCounts counts = PololuSH1106BusCounts();
+  bool dataMode = false;
+};
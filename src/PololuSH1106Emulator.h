@@ -0,0 +1,318 @@
+// Copyright (C) Pololu Corporation.  See www.pololu.com for details.
+
+/// @file PololuSH1106Emulator.h
+///
+/// This file is not included by PololuOLED.h.  Include it directly if you want
+/// to use PololuSH1106Emulator.
+
+#pragma once
+
+#include "PololuSH1106Main.h"
+
+/// @brief SH1106 core class that emulates the SH1106 instead of talking to it.
+///
+/// This is a core class for use as the template parameter for PololuSH1106Main.
+/// Instead of sending commands and data to a display, it decodes them the way
+/// the SH1106 would and stores the results in a copy of the SH1106's 132x64
+/// display RAM.  You can then read the pixels that would be visible on the
+/// display with getPixel() or print them as an image with dumpPbm().
+///
+/// This class does not use any I/O pins, so it is useful for checking what
+/// the library sends to the display when no display is connected, and for
+/// checking that changes to the library do not change the image it produces.
+///
+/// The emulator supports the commands used by PololuSH1106Main: setting the
+/// column address, page address, display start line, contrast, segment remap,
+/// COM output scan direction, inverted display, and display on/off.  The
+/// second byte of any other two-byte SH1106 command is skipped.
+class PololuSH1106EmulatorCore
+{
+public:
+  /// @brief This function is called by PololuSH1106Main to perform any
+  /// initializations that might be needed for the other functions to work
+  /// properly.
+  void initPins()
+  {
+  }
+
+  /// @brief This function is called by PololuSH1106Main to reset the SH1106.
+  ///
+  /// This puts the emulated registers in their power-on reset states.  Like
+  /// on the real SH1106, the contents of the display RAM are not changed.
+  void reset()
+  {
+    page = 0;
+    column = 0;
+    startLine = 0;
+    contrast = 0x80;
+    segmentRemap = false;
+    comScanReverse = false;
+    inverted = false;
+    displayOn = false;
+    pendingCommand = 0;
+  }
+
+  /// @brief This function is called by PololuSH1106Main to start a data
+  /// transfer to the SH1106.
+  void sh1106TransferStart()
+  {
+  }
+
+  /// @brief This function is called by PololuSH1106Main to end a data
+  /// transfer to the SH1106.
+  void sh1106TransferEnd()
+  {
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are command bytes.
+  void sh1106CommandMode()
+  {
+    dataMode = false;
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are data bytes.
+  void sh1106DataMode()
+  {
+    dataMode = true;
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write commands or
+  /// data to the SH1106.
+  ///
+  /// Data bytes are stored in the display RAM at the current page and column
+  /// address, and then the column address is incremented.  Like on the
+  /// SH1106, the column address does not advance past the last column (131),
+  /// and it does not wrap around to the next page.
+  void sh1106Write(uint8_t d)
+  {
+    if (dataMode)
+    {
+      ram[page][column] = d;
+      if (column < 131) { column++; }
+      return;
+    }
+
+    if (pendingCommand)
+    {
+      if (pendingCommand == SH1106_SET_CONTRAST) { contrast = d; }
+      pendingCommand = 0;
+      return;
+    }
+
+    if (d < 0x10)
+    {
+      setColumn((column & 0xF0) | d);
+    }
+    else if (d < 0x20)
+    {
+      setColumn((column & 0x0F) | (d & 0xF) << 4);
+    }
+    else if (d >= 0x40 && d < 0x80)
+    {
+      startLine = d & 0x3F;
+    }
+    else if ((d & 0xFE) == SH1106_SET_SEGMENT_REMAP)
+    {
+      segmentRemap = d & 1;
+    }
+    else if ((d & 0xFE) == SH1106_SET_INVERT_DISPLAY)
+    {
+      inverted = d & 1;
+    }
+    else if ((d & 0xFE) == SH1106_SET_DISPLAY_ON)
+    {
+      displayOn = d & 1;
+    }
+    else if ((d & 0xF0) == SH1106_SET_PAGE_ADDR)
+    {
+      page = d & 7;
+    }
+    else if ((d & 0xF0) == SH1106_SET_COM_SCAN_DIR)
+    {
+      comScanReverse = d & 8;
+    }
+    else if (d == SH1106_SET_CONTRAST || d == 0xA8 || d == 0xAD || d == 0xD3 ||
+      d == 0xD5 || d == 0xD9 || d == 0xDA || d == 0xDB)
+    {
+      // Two-byte command: the next byte is its argument.
+      pendingCommand = d;
+    }
+  }
+
+  /// @brief Returns true if the specified pixel of the display is lit.
+  ///
+  /// The coordinates are the ones used by the library: (0, 0) is the
+  /// upper-left corner of the display in the library's default orientation,
+  /// x goes from 0 to 127, and y goes from 0 to 63.
+  ///
+  /// This takes into account the segment remap, COM scan direction, start
+  /// line, invert, and display on/off settings, so it returns what would be
+  /// visible on the display.
+  bool getPixel(uint8_t x, uint8_t y) const
+  {
+    if (!displayOn) { return false; }
+    const uint8_t ramColumn = segmentRemap ? x + 2 : 129 - x;
+    const uint8_t ramRow = ((comScanReverse ? y : 63 - y) + startLine) & 0x3F;
+    const bool on = ram[ramRow >> 3][ramColumn] >> (ramRow & 7) & 1;
+    return on != inverted;
+  }
+
+  /// @brief Returns a byte of the emulated display RAM.
+  ///
+  /// @param page The page address (0 to 7).
+  /// @param column The column address (0 to 131).
+  uint8_t getRamByte(uint8_t page, uint8_t column) const
+  {
+    return ram[page][column];
+  }
+
+  /// @brief Returns the last contrast value sent to the display.
+  uint8_t getContrast() const
+  {
+    return contrast;
+  }
+
+  /// @brief Prints the visible image as a plain (ASCII) PBM file.
+  ///
+  /// Lit pixels are printed as 1 (black) and unlit pixels as 0 (white), so
+  /// the image looks like the text on the display.  Each row of pixels takes
+  /// two lines, because PBM files should not have lines longer than 70
+  /// characters.
+  void dumpPbm(Print & out) const
+  {
+    out.print(F("P1\n128 64\n"));
+    for (uint8_t y = 0; y < 64; y++)
+    {
+      for (uint8_t x = 0; x < 128; x++)
+      {
+        out.write(getPixel(x, y) ? '1' : '0');
+        if ((x & 63) == 63) { out.write('\n'); }
+      }
+    }
+  }
+
+private:
+  void setColumn(uint8_t c)
+  {
+    column = c < 131 ? c : 131;
+  }
+
+  uint8_t ram[8][132] = {};
+  uint8_t page = 0, column = 0, startLine = 0, contrast = 0x80;
+  uint8_t pendingCommand = 0;
+  bool segmentRemap = false, comScanReverse = false;
+  bool inverted = false, displayOn = false;
+  bool dataMode = false;
+};
+
+/// @brief Emulator core class that pretends to send data in the background.
+///
+/// This is like PololuSH1106EmulatorCore, but it also implements the optional
+/// sh1106Busy() core function, like a core that sends each transfer with DMA
+/// or an SPI interrupt would.  After each transfer ends, sh1106Busy() returns
+/// true for a number of calls that depends on the number of bytes in the
+/// transfer, as if the bytes were still being sent.  The emulated display RAM
+/// is updated immediately.
+///
+/// This lets you test code that uses PololuSH1106Main::displayAsync() and
+/// PololuSH1106Main::isBusy() without a display.  The class also counts the
+/// calls to the other core functions made while it is busy, which
+/// PololuSH1106Main should never do (see getBusyViolations()).
+class PololuSH1106BusyEmulatorCore : public PololuSH1106EmulatorCore
+{
+public:
+  /// @brief Sets how many bytes are "sent" each time sh1106Busy() is called.
+  ///
+  /// The default is 16.  The bytes of a transfer include its command bytes.
+  void setBytesPerPoll(uint8_t bytes)
+  {
+    bytesPerPoll = bytes ? bytes : 1;
+  }
+
+  /// @brief Returns the number of times one of the other core functions was
+  /// called while sh1106Busy() would have returned true.
+  uint16_t getBusyViolations() const
+  {
+    return busyViolations;
+  }
+
+  /// @brief This function is called by PololuSH1106Main to check whether the
+  /// data of the last transfer is still being sent.
+  bool sh1106Busy()
+  {
+    if (!pendingBytes) { return false; }
+    pendingBytes = pendingBytes > bytesPerPoll ? pendingBytes - bytesPerPoll : 0;
+    return true;
+  }
+
+  /// @brief This function is called by PololuSH1106Main to start a data
+  /// transfer to the SH1106.
+  void sh1106TransferStart()
+  {
+    checkNotBusy();
+    PololuSH1106EmulatorCore::sh1106TransferStart();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to end a data
+  /// transfer to the SH1106.
+  ///
+  /// This is when the emulated background transfer starts.
+  void sh1106TransferEnd()
+  {
+    checkNotBusy();
+    PololuSH1106EmulatorCore::sh1106TransferEnd();
+    pendingBytes = transferBytes;
+    transferBytes = 0;
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are command bytes.
+  void sh1106CommandMode()
+  {
+    checkNotBusy();
+    PololuSH1106EmulatorCore::sh1106CommandMode();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are data bytes.
+  void sh1106DataMode()
+  {
+    checkNotBusy();
+    PololuSH1106EmulatorCore::sh1106DataMode();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write commands or
+  /// data to the SH1106.
+  void sh1106Write(uint8_t d)
+  {
+    checkNotBusy();
+    transferBytes++;
+    PololuSH1106EmulatorCore::sh1106Write(d);
+  }
+
+private:
+  void checkNotBusy()
+  {
+    if (pendingBytes) { busyViolations++; }
+  }
+
+  uint16_t pendingBytes = 0, transferBytes = 0, busyViolations = 0;
+  uint8_t bytesPerPoll = 16;
+};
+
+/// @brief SH1106 class that emulates an SH1106 in RAM.
+///
+/// To use this class, you must include PololuSH1106Emulator.h.  Note that it
+/// uses about 1 KB of RAM for the emulated display RAM.
+///
+/// The emulator is the public core member, so you can print what would be
+/// visible on the display like this:
+///
+/// ```{.cpp}
+/// display.core.dumpPbm(Serial);
+/// ```
+class PololuSH1106Emulator : public PololuSH1106Main<PololuSH1106EmulatorCore>
+{
+};
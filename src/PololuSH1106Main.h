@@ -8,6 +8,7 @@
 
 #define SH1106_SET_COLUMN_ADDR_LOW 0x00
 #define SH1106_SET_COLUMN_ADDR_HIGH 0x10
+#define SH1106_SET_START_LINE 0x40
 #define SH1106_SET_CONTRAST 0x81
 #define SH1106_SET_SEGMENT_REMAP 0xA0
 #define SH1106_SET_INVERT_DISPLAY 0xA6
@@ -15,6 +16,196 @@
 #define SH1106_SET_PAGE_ADDR 0xB0
 #define SH1106_SET_COM_SCAN_DIR 0xC0
 
+/// @brief Timing statistics for one kind of update, recorded by
+/// PololuSH1106Main when POLOLU_OLED_STATS is defined.
+///
+/// The average time in microseconds is totalMicros / count.
+struct PololuSH1106TimeStats
+{
+  uint32_t count;
+  uint32_t minMicros;
+  uint32_t maxMicros;
+  uint32_t totalMicros;
+};
+
+/// @brief Statistics recorded by PololuSH1106Main when POLOLU_OLED_STATS is
+/// defined.  See PololuSH1106Main::getStats().
+struct PololuSH1106Stats
+{
+  /// The number of data bytes sent to the SH1106.
+  uint32_t dataBytes;
+
+  /// The number of command bytes sent to the SH1106.
+  uint32_t commandBytes;
+
+  /// The number of times the whole display RAM was cleared.
+  uint32_t clearDisplayRamCount;
+
+  /// Calls to display() and the time they took.
+  PololuSH1106TimeStats display;
+
+  /// Calls to displayPartial() and the time they took.  This includes the
+  /// partial updates done automatically by write(), print(), and flush().
+  PololuSH1106TimeStats displayPartial;
+};
+
+/// @brief A copy of the OLED's RAM for PololuSH1106Main::setShadowBuffer().
+///
+/// This takes up 1029 bytes of RAM on AVRs.  The display keeps it up to date
+/// while it is in use, so there is nothing in it for your sketch to read or
+/// modify.
+class PololuSH1106ShadowBuffer
+{
+  template<class, uint8_t, uint8_t, class, bool>
+  friend class PololuSH1106Main;
+
+  // The bytes of the OLED's RAM, in the order of its pages.
+  uint8_t ram[8][128];
+
+  // Where the next data byte goes, and the number of bytes left before the
+  // end of its page (or 0 if data bytes are not being sent).
+  uint8_t * cursor;
+  uint8_t remaining;
+
+  // Calls the display's writePageChanges().  This is set by setShadowBuffer(),
+  // so writePageChanges() only takes up program space in sketches that call
+  // it.
+  void (*writePageChanges)(void * display, uint8_t page, uint8_t runCost);
+};
+
+/// @brief The tile images used by PololuSH1106Main::setLayoutTiles().
+///
+/// Tiles 0 through ramTileCount - 1 come from ramTiles, and tile N for any
+/// higher N comes from tiles + (N - ramTileCount) * 8.  Each tile is 8 bytes,
+/// one for each column from left to right, with the least-significant bit of
+/// each byte holding the top pixel.
+struct PololuSH1106TileSet
+{
+  /// A pointer to the tile images in program space.
+  const uint8_t * tiles;
+
+  /// A pointer to a bank of tile images in RAM, or nullptr.
+  const uint8_t * ramTiles;
+
+  /// The number of tiles in the RAM tile bank.
+  uint8_t ramTileCount;
+};
+
+/// @brief The part of a PololuSH1106ScrollbackBuffer that does not depend on
+/// its size.
+class PololuSH1106Scrollback
+{
+  template<class, uint8_t, uint8_t, class, bool>
+  friend class PololuSH1106Main;
+
+protected:
+  PololuSH1106Scrollback(uint8_t * lines, uint8_t size)
+  {
+    this->lines = lines;
+    this->size = size;
+    next = 0;
+    count = 0;
+    view = 0;
+  }
+
+private:
+  // The saved lines, used as a ring, and the number of lines it can hold.
+  uint8_t * lines;
+  uint8_t size;
+
+  // The index of the line to replace next, the number of lines saved, and
+  // the number of them shown by setScrollbackView().
+  uint8_t next;
+  uint8_t count;
+  uint8_t view;
+};
+
+/// @brief A buffer for PololuSH1106Main::setScrollbackBuffer() that holds
+/// the last lineCount lines that scrolled off the top in terminal mode.
+///
+/// lineWidth must be the same as the text buffer width of the display (21
+/// by default).  This takes up lineCount * lineWidth + 6 bytes of RAM on
+/// AVRs.
+template <uint8_t lineCount, uint8_t lineWidth = 21>
+class PololuSH1106ScrollbackBuffer : public PololuSH1106Scrollback
+{
+  static_assert(lineCount > 0, "The scrollback buffer must hold a line.");
+
+public:
+  PololuSH1106ScrollbackBuffer() : PololuSH1106Scrollback(storage[0], lineCount)
+  {
+  }
+
+private:
+  uint8_t storage[lineCount][lineWidth];
+};
+
+/// @brief Selects the 8x2 layout for PololuSH1106Fixed.
+struct PololuSH1106Layout8x2
+{
+  static const uint8_t width = 8, height = 2;
+  template <class D> static void select(D & display) { display.setLayout8x2(); }
+};
+
+/// @brief Selects the 11x4 layout for PololuSH1106Fixed.
+struct PololuSH1106Layout11x4
+{
+  static const uint8_t width = 11, height = 4;
+  template <class D> static void select(D & display) { display.setLayout11x4(); }
+};
+
+/// @brief Selects the 21x8 layout for PololuSH1106Fixed.
+struct PololuSH1106Layout21x8
+{
+  static const uint8_t width = 21, height = 8;
+  template <class D> static void select(D & display) { display.setLayout21x8(); }
+};
+
+/// @cond
+
+// The layout state of a PololuSH1106Main whose layout is selected at run
+// time.  D is the display class.  A display with a fixed layout (see
+// PololuSH1106Fixed) gets its geometry and display routines from the layout
+// at compile time, so it uses this empty version instead.
+template <class D, class FixedLayout> class PololuSH1106LayoutState
+{
+};
+
+template <class D> class PololuSH1106LayoutState<D, void>
+{
+protected:
+  PololuSH1106LayoutState()
+  {
+    displayPartialFunction = nullptr;
+    displayPagesFunction = nullptr;
+    layoutWidth = 0;
+    layoutHeight = 0;
+    textScaleX = 1;
+    textScaleY = 1;
+    tileSet = nullptr;
+  }
+
+  // We use the display routines through these member function pointers and
+  // are careful about where we refer to them so that the routines for
+  // unused layouts do not take up program space.  displayPagesFunction is
+  // nullptr for layouts without graphics.
+  void (D::*displayPartialFunction)(uint8_t, uint8_t, uint8_t);
+  void (D::*displayPagesFunction)(uint8_t, uint8_t);
+
+  // The number of columns and rows of text shown by the current layout.
+  uint8_t layoutWidth;
+  uint8_t layoutHeight;
+
+  // The scale factors of the layout selected by setLayoutScaled().
+  uint8_t textScaleX;
+  uint8_t textScaleY;
+
+  // The tiles used by the layout selected by setLayoutTiles().
+  const PololuSH1106TileSet * tileSet;
+};
+
+/// @endcond
+
 /// @brief This class makes it easy to display text and graphics on a
 /// 128x64 SH1106 OLED.
 ///
@@ -35,6 +226,41 @@
 ///
 /// For an example implementation of a core class, see PololuSH1106Core.
 ///
+/// The core class can optionally implement the following functions, which
+/// write a run of data bytes in one call.  If they are present, this class
+/// detects them at compile time and uses them to send long runs of data, such
+/// as a page of the graphics buffer or the columns of a glyph, instead of
+/// calling sh1106Write() for each byte.  This can be much faster for cores
+/// that use an SPI FIFO, DMA, or an operating system driver.
+///
+/// - void sh1106WriteBuffer(const uint8_t * data, uint16_t length);
+/// - void sh1106WriteBufferFromProgmem(const uint8_t * data, uint16_t length);
+///
+/// The first function reads the data from RAM and the second reads it
+/// from program space.
+///
+/// A core class that can send data in the background (for example, using DMA
+/// or an SPI interrupt) can also implement this function:
+///
+/// - bool sh1106Busy();
+///
+/// It should return true while the core is still sending data from a
+/// previous transfer.  This class never calls the other core functions while
+/// sh1106Busy() returns true, so such a core can queue the bytes of a
+/// transfer and send them after sh1106TransferEnd() returns.  This is what
+/// makes displayAsync() non-blocking.  PololuSH1106BusyEmulatorCore, in
+/// PololuSH1106Emulator.h, is a simple example of such a core.
+///
+/// A core class can also tell this class how expensive it is to start a new
+/// run of data bytes, which is used by setShadowBuffer():
+///
+/// - uint8_t sh1106RunCost();
+///
+/// It should return the number of data bytes that take about as long to send
+/// as the 3 command bytes that set the page and column address, plus the
+/// switches to command mode and back to data mode.  If the core class does
+/// not have this function, this class assumes 3.
+///
 /// @section text-buffer Text buffer
 ///
 /// This class holds a text buffer to keep track of what text to show on the
@@ -53,6 +279,16 @@
 /// to a specific line in the text buffer, and then manipulate the characters
 /// using arbitrary code.
 ///
+/// This class keeps track of which characters in the text buffer have changed
+/// since they were last written to the OLED.  In layouts without a graphics
+/// buffer, display() only writes those characters.  The clear(), write(),
+/// print(), scrollDisplayUp(), and getLinePointer() functions keep track of
+/// changes automatically, and writing a character that is already present in
+/// the text buffer does not count as a change.  If you modify the text buffer
+/// using a pointer you got from getLinePointer() before the last call to
+/// display(), you should call markDirty() to tell this class which characters
+/// changed.
+///
 /// @section font Font
 ///
 /// This library maps each character code from 0 to 255 to a corresponding
@@ -71,6 +307,18 @@
 /// To do so, simply copy the file font.cpp into your sketch directory,
 /// remove `__attribute__((weak))`, and then make your changes.
 ///
+/// The 21x8 layouts can also draw some or all lines of text with a
+/// proportional font described by a PololuOLEDFont, which each object
+/// selects with setFont().
+///
+/// The 8x2 and 11x4 layouts draw each glyph at double size.  By default, each
+/// half of a double-size glyph is computed separately using a small table.
+/// If you add `#define POLOLU_OLED_FAST_DOUBLE_TEXT` before including this
+/// library, it instead reads each glyph only once per line of text and doubles
+/// its columns using a 512-byte table in program space that is generated at
+/// compile time.  This uses more program space but makes the rendering
+/// faster, which is noticeable with a fast core class.
+///
 /// @section graphics-buffer Graphics buffer
 ///
 /// This class can be configured to hold a pointer to an external 1024-byte
@@ -84,6 +332,40 @@
 /// You can define and manipulate this graphics buffer using your own code, or
 /// you can use a third-party library such as Adafruit_SSD1306 to do it.
 ///
+/// If only small parts of the graphics buffer change between calls to
+/// display(), you can call skipUnchangedPages().  In that mode, this class
+/// remembers a 16-bit checksum of the graphics and text that it last wrote to
+/// each of the 8 pages (8-pixel-high rows) of the screen, in an array that
+/// you provide, and display() skips pages whose checksum has not changed.
+///
+/// If you do not have 1024 bytes of RAM to spare, each of the layouts with
+/// graphics also has a version that takes a callback function instead of a
+/// graphics buffer, such as setLayout8x2WithGraphicsCallback().  Just before
+/// this class writes a page of the screen, it clears a 128-byte strip and
+/// calls the callback to draw that page's graphics on it, in the same format
+/// as one page of the graphics buffer:
+///
+/// ```{.cpp}
+/// uint8_t pageStrip[128];
+///
+/// void drawPage(uint8_t page, uint8_t * strip)
+/// {
+///   // Draw a horizontal line across the middle of the screen.
+///   if (page == 4) { memset(strip, 0x01, 128); }
+/// }
+///
+/// void setup()
+/// {
+///   display.setLayout8x2WithGraphicsCallback(drawPage, pageStrip);
+/// }
+/// ```
+///
+/// The page numbers count from the top of the screen, from 0 to 7.  The
+/// callback might be called more than once for the same page during an
+/// update (for example, in skipUnchangedPages() mode, or when writing
+/// part of a page), so it should draw the same thing every time until you
+/// call display() to show a change.
+///
 /// @section lcd-compat HD44780 LCD class compatibility
 ///
 /// This class implements clear(), gotoXY(), write(),
@@ -106,49 +388,381 @@
 ///
 /// The display() function turns auto-display mode back on, so you will need to
 /// call noAutoDisplay() again whenever you want to do a flickerless update.
-template<class C> class PololuSH1106Main : public Print
+///
+/// In auto-display mode, each call to write() results in a separate update
+/// of the OLED, so printing a string one character at a time (for example,
+/// with print(F("..."))) costs much more than printing it all at once.
+/// To avoid that, you can call beginUpdate() before writing the text and
+/// endUpdate() afterwards: the changes are accumulated and then written with
+/// one update per line of text.
+///
+/// @section stats Statistics
+///
+/// If you add `#define POLOLU_OLED_STATS` before including this library, this
+/// class records how many bytes it sends to the SH1106 and how long display()
+/// and displayPartial() take, which you can read with getStats().  Without
+/// that definition, the statistics do not use any program space or RAM.
+///
+/// @section text-buffer-size Text buffer size
+///
+/// By default, the text buffer holds 21 columns and 8 rows of text, which is
+/// enough for every layout.  If you only use one layout, you can pass smaller
+/// numbers as the optional textBufferWidth and textBufferHeight template
+/// parameters to save RAM, but it is easier to use PololuSH1106Fixed, which
+/// sizes the text buffer to fit a layout and selects that layout.  Trying to
+/// select a layout that does not fit in the text buffer is a compile-time
+/// error.
+///
+/// PololuSH1106Fixed also passes its layout as the optional FixedLayout
+/// template parameter.  A display with a fixed layout does not keep the
+/// layout's geometry or display routines in RAM, and selecting any other
+/// layout is a compile-time error.  The default, void, lets you select the
+/// layout at run time.
+///
+/// The last template parameter, sharedCustomChars, is only set by
+/// PololuSH1106Multi.  A display with sharedCustomChars set to true reads its
+/// custom characters from a table that it shares with the other displays of
+/// a PololuSH1106Multi, and its own functions for defining custom characters
+/// cannot be used.
+template<class C, uint8_t textBufferWidth = 21, uint8_t textBufferHeight = 8,
+  class FixedLayout = void, bool sharedCustomChars = false>
+class PololuSH1106Main : public Print,
+  private PololuSH1106LayoutState<PololuSH1106Main<C, textBufferWidth,
+    textBufferHeight, FixedLayout, sharedCustomChars>, FixedLayout>
 {
+  template<class, uint8_t> friend class PololuSH1106Multi;
+
+  // BoolConstant<true> if this display has a fixed layout.  The functions
+  // that take it as an argument keep the layout state (see
+  // PololuSH1106LayoutState) out of displays with a fixed layout.
+  typedef PololuOLEDHelpers::BoolConstant<
+    !PololuOLEDHelpers::IsSame<FixedLayout, void>::value> HasFixedLayout;
+
 public:
 
+  // Every member is initialized here (or by the layout functions), so
+  // objects that are not statically allocated work too.
   PololuSH1106Main()
   {
+#ifdef POLOLU_OLED_STATS
+    resetStats();
+    statsDataMode = false;
+#endif
+    initialized = false;
+    transferDepth = 0;
+    disableAutoDisplay = false;
+    updateDepth = 0;
+    pageSignatures = nullptr;
+    clip = nullptr;
+    shadowBuffer = nullptr;
+    hardwareScrollEnabled = false;
+    startLine = 0;
+    startLinePending = false;
+    textFont = nullptr;
+    fontLines = 0;
+    fontLineFunction = nullptr;
+    framePosition = noFrame;
+    frameCallback = nullptr;
     memset(textBuffer, ' ', sizeof(textBuffer));
-    setLayout8x2();
+    textBackBuffer = nullptr;
+    terminalEnabled = false;
+    scrollback = nullptr;
+    markAllDirty();
+    textCursorX = 0;
+    textCursorY = 0;
+    initCustomChars(PololuOLEDHelpers::BoolConstant<sharedCustomChars>());
+    graphicsCallback = nullptr;
+    setDefaultLayout(HasFixedLayout());
   }
 
   //// Low-level helpers
 private:
 
-  void clearDisplayRam()
+  // Returns true if the core is still sending data in the background.
+  bool coreBusy()
+  {
+    return coreBusy(PololuOLEDHelpers::BoolConstant<
+      PololuOLEDHelpers::HasBusy<C>::value>());
+  }
+
+  bool coreBusy(PololuOLEDHelpers::BoolConstant<true>)
+  {
+    return core.sh1106Busy();
+  }
+
+  bool coreBusy(PololuOLEDHelpers::BoolConstant<false>)
+  {
+    return false;
+  }
+
+  // Every transfer starts here, which waits for the core to finish sending
+  // data in the background.  Transfers can be nested, so that a function that
+  // writes several parts of the screen can send them all in one transfer:
+  // only the outermost calls reach the core.
+  void sh1106TransferStart()
   {
+    if (transferDepth++) { return; }
+    while (coreBusy()) {}
     core.sh1106TransferStart();
+  }
+
+  void sh1106TransferEnd()
+  {
+    if (--transferDepth) { return; }
+    core.sh1106TransferEnd();
+  }
+
+  // All commands and data go through these functions (or the writeBuffer
+  // functions below) so that they can be counted when POLOLU_OLED_STATS is
+  // defined.
+  void sh1106CommandMode()
+  {
+#ifdef POLOLU_OLED_STATS
+    statsDataMode = false;
+#endif
+    if (shadowBuffer) { shadowBuffer->remaining = 0; }
     core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | 2);
+  }
+
+  void sh1106DataMode()
+  {
+#ifdef POLOLU_OLED_STATS
+    statsDataMode = true;
+#endif
+    core.sh1106DataMode();
+  }
+
+  void sh1106Write(uint8_t d)
+  {
+    countBytes(1);
+    core.sh1106Write(d);
+    updateShadow(d);
+  }
+
+  // The state of a write done by displayGraphicsRect() or writePageChanges(),
+  // which only sends the data bytes for pixel columns from left up to (but
+  // not including) right.  page and column give the position of the next data
+  // byte.  If capture is not nullptr, the bytes are stored there instead of
+  // being sent.  These functions keep it on the stack and point clip to it
+  // while they are writing.
+  //
+  // writeData() writes the data bytes with the write function.  It only
+  // points to writeClipped() in the functions above, so writeClipped() only
+  // takes up program space in sketches that use them.
+  struct Clip
+  {
+    void (PololuSH1106Main::*write)(uint8_t);
+    uint8_t left;
+    uint8_t right;
+    uint8_t page;
+    uint8_t column;
+    bool addressPending;
+    uint8_t * capture;
+  };
+
+  // Writes a data byte with sh1106Write(), or with the write function of the
+  // clipped write in progress.  Command bytes are written with sh1106Write()
+  // directly.
+  void writeData(uint8_t d)
+  {
+    if (clip) { ((*this).*(clip->write))(d); return; }
+    sh1106Write(d);
+  }
+
+  // Sends a data byte written by displayGraphicsRect() if it is inside the
+  // rectangle, first sending the address if it has not been sent yet.  If
+  // the clip has a capture buffer, the byte is stored there instead of being
+  // sent.
+  void writeClipped(uint8_t d)
+  {
+    Clip * const c = clip;
+    const uint8_t x = c->column++;
+    if (x < c->left || x >= c->right) { return; }
+    if (c->capture)
+    {
+      c->capture[x] = d;
+      return;
+    }
+    if (c->addressPending)
+    {
+      clip = nullptr;
+      setAddress(c->page, x);
+      clip = c;
+      c->addressPending = false;
+    }
+    countBytes(1);
+    core.sh1106Write(d);
+    updateShadow(d);
+  }
+
+  // These functions copy the data bytes that are sent to the shadow buffer
+  // (see setShadowBuffer()), at the position given by the last call to
+  // setAddress().  They do nothing if there is no shadow buffer or the bytes
+  // are not data bytes.
+  void updateShadow(uint8_t d)
+  {
+    PololuSH1106ShadowBuffer * const s = shadowBuffer;
+    if (s && s->remaining)
+    {
+      *s->cursor++ = d;
+      s->remaining--;
+    }
+  }
+
+  void updateShadow(const uint8_t * data, uint16_t length)
+  {
+    PololuSH1106ShadowBuffer * const s = shadowBuffer;
+    if (!s || !s->remaining) { return; }
+    if (length > s->remaining) { length = s->remaining; }
+    memcpy(s->cursor, data, length);
+    s->cursor += length;
+    s->remaining -= length;
+  }
+
+  void updateShadowFromProgmem(const uint8_t * data, uint16_t length)
+  {
+    PololuSH1106ShadowBuffer * const s = shadowBuffer;
+    if (!s) { return; }
+    if (length > s->remaining) { length = s->remaining; }
+    for (uint16_t i = 0; i < length; i++)
+    {
+      *s->cursor++ = pgm_read_byte(data + i);
+    }
+    s->remaining -= length;
+  }
+
+  void countBytes(uint16_t length)
+  {
+#ifdef POLOLU_OLED_STATS
+    if (statsDataMode)
+    {
+      stats.dataBytes += length;
+    }
+    else
+    {
+      stats.commandBytes += length;
+    }
+#else
+    (void)length;
+#endif
+  }
+
+  // Sends data bytes from RAM, using the core's sh1106WriteBuffer() function
+  // if it has one.
+  void writeBuffer(const uint8_t * data, uint16_t length)
+  {
+    writeBuffer(data, length, PololuOLEDHelpers::BoolConstant<
+      PololuOLEDHelpers::HasWriteBuffer<C>::value>());
+  }
+
+  void writeBuffer(const uint8_t * data, uint16_t length,
+    PololuOLEDHelpers::BoolConstant<true>)
+  {
+    if (clip)
+    {
+      writeBuffer(data, length, PololuOLEDHelpers::BoolConstant<false>());
+      return;
+    }
+    countBytes(length);
+    core.sh1106WriteBuffer(data, length);
+    updateShadow(data, length);
+  }
+
+  void writeBuffer(const uint8_t * data, uint16_t length,
+    PololuOLEDHelpers::BoolConstant<false>)
+  {
+    for (uint16_t i = 0; i < length; i++) { writeData(data[i]); }
+  }
+
+  // Sends data bytes from program space, using the core's
+  // sh1106WriteBufferFromProgmem() function if it has one.
+  void writeBufferFromProgmem(const uint8_t * data, uint16_t length)
+  {
+    writeBufferFromProgmem(data, length, PololuOLEDHelpers::BoolConstant<
+      PololuOLEDHelpers::HasWriteBufferFromProgmem<C>::value>());
+  }
+
+  void writeBufferFromProgmem(const uint8_t * data, uint16_t length,
+    PololuOLEDHelpers::BoolConstant<true>)
+  {
+    if (clip)
+    {
+      writeBufferFromProgmem(data, length, PololuOLEDHelpers::BoolConstant<false>());
+      return;
+    }
+    countBytes(length);
+    core.sh1106WriteBufferFromProgmem(data, length);
+    updateShadowFromProgmem(data, length);
+  }
+
+  void writeBufferFromProgmem(const uint8_t * data, uint16_t length,
+    PololuOLEDHelpers::BoolConstant<false>)
+  {
+    for (uint16_t i = 0; i < length; i++)
+    {
+      writeData(pgm_read_byte(data + i));
+    }
+  }
+
+  void writeZeros(uint8_t length)
+  {
+    writeZeros(length, PololuOLEDHelpers::BoolConstant<
+      PololuOLEDHelpers::HasWriteBuffer<C>::value>());
+  }
+
+  void writeZeros(uint8_t length, PololuOLEDHelpers::BoolConstant<true>)
+  {
+    uint8_t zeros[32] = { 0 };
+    while (length > sizeof(zeros))
+    {
+      writeBuffer(zeros, sizeof(zeros));
+      length -= sizeof(zeros);
+    }
+    writeBuffer(zeros, length);
+  }
+
+  void writeZeros(uint8_t length, PololuOLEDHelpers::BoolConstant<false>)
+  {
+    for (uint8_t i = 0; i < length; i++) { writeData(0); }
+  }
+
+  void clearDisplayRam()
+  {
+#ifdef POLOLU_OLED_STATS
+    stats.clearDisplayRamCount++;
+#endif
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | 2);
     for (uint8_t page = 0; page < 8; page++)
     {
-      core.sh1106CommandMode();
-      core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-      core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | 0);
-      core.sh1106DataMode();
-      for (uint8_t i = 0; i < 128; i++)
-      {
-        core.sh1106Write(0);
-      }
+      sh1106CommandMode();
+      sh1106Write(SH1106_SET_PAGE_ADDR | page);
+      sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | 0);
+      sh1106DataMode();
+      writeZeros(128);
     }
-    core.sh1106TransferEnd();
+    sh1106TransferEnd();
     clearDisplayRamOnNextDisplay = false;
+    forgetPageSignatures(0xFF);
+    if (shadowBuffer)
+    {
+      memset(shadowBuffer->ram, 0, sizeof(shadowBuffer->ram));
+    }
+    markAllDirty();
   }
 
   void configureDefault()
   {
-    core.sh1106TransferStart();
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_SEGMENT_REMAP | 1);  // flip horizontally
-    core.sh1106Write(SH1106_SET_COM_SCAN_DIR | 8);   // flip vertically
-    core.sh1106Write(SH1106_SET_CONTRAST);
-    core.sh1106Write(0xFF);                // maximum brightness
-    core.sh1106Write(SH1106_SET_DISPLAY_ON | 1);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_SEGMENT_REMAP | 1);  // flip horizontally
+    sh1106Write(SH1106_SET_COM_SCAN_DIR | 8);   // flip vertically
+    sh1106Write(SH1106_SET_START_LINE | 0);
+    sh1106Write(SH1106_SET_CONTRAST);
+    sh1106Write(0xFF);                // maximum brightness
+    sh1106Write(SH1106_SET_DISPLAY_ON | 1);
+    sh1106TransferEnd();
   }
 
   //////// Initialization and settings
@@ -157,10 +771,13 @@ private:
 
   void init2()
   {
+    while (coreBusy()) {}
     core.initPins();
     core.reset();
     clearDisplayRam();
     configureDefault();
+    startLine = 0;
+    startLinePending = false;
     initialized = true;
   }
 
@@ -195,31 +812,31 @@ public:
   void invert()
   {
     init();
-    core.sh1106TransferStart();
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_INVERT_DISPLAY | 1);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_INVERT_DISPLAY | 1);
+    sh1106TransferEnd();
   }
 
   /// @brief Configures the OLED to not invert its pixels (the default).
   void noInvert()
   {
     init();
-    core.sh1106TransferStart();
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_INVERT_DISPLAY | 0);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_INVERT_DISPLAY | 0);
+    sh1106TransferEnd();
   }
 
   /// @brief Configures the OLED to rotate its display 180 degrees from normal.
   void rotate180()
   {
     init();
-    core.sh1106TransferStart();
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_SEGMENT_REMAP);
-    core.sh1106Write(SH1106_SET_COM_SCAN_DIR);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_SEGMENT_REMAP);
+    sh1106Write(SH1106_SET_COM_SCAN_DIR);
+    sh1106TransferEnd();
   }
 
   /// @brief Configures the OLED to use the default orientation.
@@ -232,11 +849,11 @@ public:
   void noRotate()
   {
     init();
-    core.sh1106TransferStart();
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_SEGMENT_REMAP | 1);
-    core.sh1106Write(SH1106_SET_COM_SCAN_DIR | 8);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_SEGMENT_REMAP | 1);
+    sh1106Write(SH1106_SET_COM_SCAN_DIR | 8);
+    sh1106TransferEnd();
   }
 
   /// @brief Sets the contrast (i.e. brightness) of the OLED.
@@ -246,20 +863,98 @@ public:
   void setContrast(uint8_t contrast)
   {
     init();
-    core.sh1106TransferStart();
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_CONTRAST);
-    core.sh1106Write(contrast);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sh1106Write(SH1106_SET_CONTRAST);
+    sh1106Write(contrast);
+    sh1106TransferEnd();
+  }
+
+private:
+
+  // Updates startLine.  If the start line moves by whole pages, the page
+  // signatures are rotated to match the pages that are now shown at each
+  // position.  The command is not sent until sendPendingStartLine() is
+  // called, which setAddress() does before the next data is written, so the
+  // OLED does not show the new start line before the data that goes with it.
+  void moveStartLine(uint8_t line)
+  {
+    line &= 63;
+    const uint8_t pages = ((line >> 3) - (startLine >> 3)) & 7;
+    if (pages && pageSignatures)
+    {
+      uint16_t oldSignatures[8];
+      memcpy(oldSignatures, pageSignatures, sizeof(oldSignatures));
+      for (uint8_t page = 0; page < 8; page++)
+      {
+        pageSignatures[page] = oldSignatures[(page + pages) & 7];
+      }
+    }
+    startLine = line;
+    startLinePending = true;
+  }
+
+  // Sends the display start line command if moveStartLine() changed it.
+  // This must be called in command mode.
+  void sendPendingStartLine()
+  {
+    if (!startLinePending) { return; }
+    sh1106Write(SH1106_SET_START_LINE | startLine);
+    startLinePending = false;
   }
 
+public:
+
+  /// @brief Sets the display start line of the OLED, which scrolls the whole
+  /// image up in hardware without sending any pixels.
+  ///
+  /// @param line The number of pixel rows to scroll up, between 0 (default)
+  /// and 63.  Rows that scroll off the top of the screen reappear at the
+  /// bottom.
+  ///
+  /// This is useful for smooth scrolling with a graphics layout: step the
+  /// line up one pixel at a time, and every 8 pixels, when the content has
+  /// moved by a whole page, move the contents of your graphics buffer up by
+  /// 128 bytes and draw the new bottom page.  The page numbers used by this
+  /// class follow the start line in steps of 8 pixels, so after that the
+  /// graphics buffer matches what is on the screen again, and in
+  /// skipUnchangedPages() mode the next call to display() only writes the
+  /// pages that really changed.
+  ///
+  /// In layouts without a graphics buffer, the text does not move with the
+  /// image, so all of it is marked as dirty when the start line moves by a
+  /// page.
+  ///
+  /// If an update started by displayAsync() or displayStep() is in progress,
+  /// this function finishes it first.  The start line is reset to 0 by
+  /// reinitialize().
+  void setDisplayStartLine(uint8_t line)
+  {
+    init();
+    waitDone();
+    if (((line >> 3) ^ (startLine >> 3)) & 7) { markAllDirty(); }
+    moveStartLine(line);
+    sh1106TransferStart();
+    sh1106CommandMode();
+    sendPendingStartLine();
+    sh1106TransferEnd();
+  }
+
+  /// @brief Returns the display start line set by setDisplayStartLine() or
+  /// changed by scrollDisplayUp() in hardwareScroll() mode.
+  uint8_t getDisplayStartLine() { return startLine; }
+
   /// @brief Configures this library to use its default layout, which allows for
   /// 8 columns and 2 rows of text.
   void setLayout8x2()
   {
+    static_assert(textBufferWidth >= 8 && textBufferHeight >= 2,
+      "The text buffer is too small for this layout.");
+    static_assert(canSelectLayout<PololuSH1106Layout8x2>(),
+      "This display has a different fixed layout.");
     graphicsBuffer = nullptr;
-    displayFunction = &PololuSH1106Main::display8x2Text;
-    displayPartialFunction = &PololuSH1106Main::display8x2TextPartial;
+    selectLayout(8, 2, &PololuSH1106Main::display8x2TextPartial, nullptr,
+      HasFixedLayout());
     clearDisplayRamOnNextDisplay = true;
   }
 
@@ -269,12 +964,33 @@ public:
   /// @param graphics A pointer to a 1024-byte graphics buffer.
   void setLayout8x2WithGraphics(const uint8_t * graphics)
   {
+    static_assert(textBufferWidth >= 8 && textBufferHeight >= 2,
+      "The text buffer is too small for this layout.");
+    static_assert(canSelectLayout<PololuSH1106Layout8x2>(),
+      "This display has a different fixed layout.");
     graphicsBuffer = graphics;
-    displayFunction = &PololuSH1106Main::display8x2TextAndGraphics;
-    displayPartialFunction = &PololuSH1106Main::display8x2TextAndGraphicsPartial;
+    graphicsCallback = nullptr;
+    selectLayout(8, 2,
+      &PololuSH1106Main::display8x2TextAndGraphicsPartial,
+      &PololuSH1106Main::display8x2TextAndGraphicsPages, HasFixedLayout());
     clearDisplayRamOnNextDisplay = true;
   }
 
+  /// @brief Configures this library to use the 8x2 layout with graphics drawn
+  /// by a callback function instead of a graphics buffer.
+  ///
+  /// See the "Graphics buffer" section.
+  ///
+  /// @param callback A function that draws one page of graphics.  Its
+  ///   arguments are the page (0 to 7) and a pointer to the strip.
+  /// @param strip A pointer to a 128-byte buffer for the callback to draw on.
+  void setLayout8x2WithGraphicsCallback(
+    void (*callback)(uint8_t page, uint8_t * strip), uint8_t * strip)
+  {
+    setLayout8x2WithGraphics(strip);
+    graphicsCallback = callback;
+  }
+
   /// @brief Configures this library to use a layout with
   /// 11 columns and 4 rows of text.
   ///
@@ -283,9 +999,13 @@ public:
   /// for narrow characters such as punctuation.
   void setLayout11x4()
   {
+    static_assert(textBufferWidth >= 11 && textBufferHeight >= 4,
+      "The text buffer is too small for this layout.");
+    static_assert(canSelectLayout<PololuSH1106Layout11x4>(),
+      "This display has a different fixed layout.");
     graphicsBuffer = nullptr;
-    displayFunction = &PololuSH1106Main::display11x4Text;
-    displayPartialFunction = &PololuSH1106Main::display11x4TextPartial;
+    selectLayout(11, 4, &PololuSH1106Main::display11x4TextPartial, nullptr,
+      HasFixedLayout());
     clearDisplayRamOnNextDisplay = true;
   }
 
@@ -299,19 +1019,44 @@ public:
   /// for narrow characters such as punctuation.
   void setLayout11x4WithGraphics(const uint8_t * graphics)
   {
+    static_assert(textBufferWidth >= 11 && textBufferHeight >= 4,
+      "The text buffer is too small for this layout.");
+    static_assert(canSelectLayout<PololuSH1106Layout11x4>(),
+      "This display has a different fixed layout.");
     graphicsBuffer = graphics;
-    displayFunction = &PololuSH1106Main::display11x4TextAndGraphics;
-    displayPartialFunction = &PololuSH1106Main::display11x4TextAndGraphicsPartial;
+    graphicsCallback = nullptr;
+    selectLayout(11, 4,
+      &PololuSH1106Main::display11x4TextAndGraphicsPartial,
+      &PololuSH1106Main::display11x4TextAndGraphicsPages, HasFixedLayout());
     clearDisplayRamOnNextDisplay = true;
   }
 
+  /// @brief Configures this library to use the 11x4 layout with graphics drawn
+  /// by a callback function instead of a graphics buffer.
+  ///
+  /// See the "Graphics buffer" section.
+  ///
+  /// @param callback A function that draws one page of graphics.  Its
+  ///   arguments are the page (0 to 7) and a pointer to the strip.
+  /// @param strip A pointer to a 128-byte buffer for the callback to draw on.
+  void setLayout11x4WithGraphicsCallback(
+    void (*callback)(uint8_t page, uint8_t * strip), uint8_t * strip)
+  {
+    setLayout11x4WithGraphics(strip);
+    graphicsCallback = callback;
+  }
+
   /// @brief Configures this library to use a layout with
   /// 21 columns and 8 rows of text.
   void setLayout21x8()
   {
+    static_assert(textBufferWidth >= 21 && textBufferHeight >= 8,
+      "The text buffer is too small for this layout.");
+    static_assert(canSelectLayout<PololuSH1106Layout21x8>(),
+      "This display has a different fixed layout.");
     graphicsBuffer = nullptr;
-    displayFunction = &PololuSH1106Main::display21x8Text;
-    displayPartialFunction = &PololuSH1106Main::display21x8TextPartial;
+    selectLayout(21, 8, &PololuSH1106Main::display21x8TextPartial, nullptr,
+      HasFixedLayout());
     clearDisplayRamOnNextDisplay = true;
   }
 
@@ -321,17 +1066,241 @@ public:
   /// @param graphics A pointer to a 1024-byte graphics buffer.
   void setLayout21x8WithGraphics(const uint8_t * graphics)
   {
+    static_assert(textBufferWidth >= 21 && textBufferHeight >= 8,
+      "The text buffer is too small for this layout.");
+    static_assert(canSelectLayout<PololuSH1106Layout21x8>(),
+      "This display has a different fixed layout.");
     graphicsBuffer = graphics;
-    displayFunction = &PololuSH1106Main::display21x8TextAndGraphics;
-    displayPartialFunction = &PololuSH1106Main::display21x8TextAndGraphicsPartial;
+    graphicsCallback = nullptr;
+    selectLayout(21, 8,
+      &PololuSH1106Main::display21x8TextAndGraphicsPartial,
+      &PololuSH1106Main::display21x8TextAndGraphicsPages, HasFixedLayout());
     clearDisplayRamOnNextDisplay = true;
   }
 
-  //////// Display routines
-
-private:
+  /// @brief Configures this library to use the 21x8 layout with graphics drawn
+  /// by a callback function instead of a graphics buffer.
+  ///
+  /// See the "Graphics buffer" section.
+  ///
+  /// @param callback A function that draws one page of graphics.  Its
+  ///   arguments are the page (0 to 7) and a pointer to the strip.
+  /// @param strip A pointer to a 128-byte buffer for the callback to draw on.
+  void setLayout21x8WithGraphicsCallback(
+    void (*callback)(uint8_t page, uint8_t * strip), uint8_t * strip)
+  {
+    setLayout21x8WithGraphics(strip);
+    graphicsCallback = callback;
+  }
 
-  uint8_t getGlyphColumn(uint8_t glyph, uint8_t pixelX)
+  /// @brief Configures this library to use a layout with text scaled by any
+  /// whole number.
+  ///
+  /// @param scaleX The horizontal scale, from 1 to 8.
+  /// @param scaleY The vertical scale, from 1 to 8.
+  ///
+  /// Each character is drawn scaleX times wider and scaleY times taller than
+  /// in the 21x8 layout, and the layout has as many columns and rows as fit
+  /// on the screen, centered.  For example, (4, 4) gives 5 columns and 2 rows
+  /// for large numeric readouts, (5, 8) gives 4 columns and 1 row, and (2, 1)
+  /// gives 10 columns and 8 rows of double-width text.  Use getLayoutWidth()
+  /// and getLayoutHeight() to find the size.  The layout is limited to the
+  /// size of the text buffer.
+  ///
+  /// The characters are stretched while they are being sent, so this does
+  /// not need a graphics buffer.  It is slower than the 8x2 and 11x4 layouts,
+  /// which are specialized for double-size text.
+  void setLayoutScaled(uint8_t scaleX, uint8_t scaleY)
+  {
+    static_assert(!HasFixedLayout::value,
+      "This display has a fixed layout.");
+    setScaledGeometry(scaleX, scaleY);
+    graphicsBuffer = nullptr;
+    this->displayPartialFunction =
+      &PololuSH1106Main::displayScaledTextPartial<false>;
+    this->displayPagesFunction = nullptr;
+    clearDisplayRamOnNextDisplay = true;
+  }
+
+  /// @brief Configures this library to use a layout with text scaled by any
+  /// whole number, XORed with a graphics buffer.
+  ///
+  /// See setLayoutScaled().
+  ///
+  /// @param scaleX The horizontal scale, from 1 to 8.
+  /// @param scaleY The vertical scale, from 1 to 8.
+  /// @param graphics A pointer to a 1024-byte graphics buffer.
+  void setLayoutScaledWithGraphics(uint8_t scaleX, uint8_t scaleY,
+    const uint8_t * graphics)
+  {
+    static_assert(!HasFixedLayout::value,
+      "This display has a fixed layout.");
+    setScaledGeometry(scaleX, scaleY);
+    graphicsBuffer = graphics;
+    graphicsCallback = nullptr;
+    this->displayPartialFunction =
+      &PololuSH1106Main::displayScaledTextPartial<true>;
+    this->displayPagesFunction =
+      &PololuSH1106Main::displayScaledTextAndGraphicsPages;
+    clearDisplayRamOnNextDisplay = true;
+  }
+
+  /// @brief Configures this library to use a layout with scaled text and
+  /// graphics drawn by a callback function instead of a graphics buffer.
+  ///
+  /// See setLayoutScaled() and the "Graphics buffer" section.
+  ///
+  /// @param scaleX The horizontal scale, from 1 to 8.
+  /// @param scaleY The vertical scale, from 1 to 8.
+  /// @param callback A function that draws one page of graphics.  Its
+  ///   arguments are the page (0 to 7) and a pointer to the strip.
+  /// @param strip A pointer to a 128-byte buffer for the callback to draw on.
+  void setLayoutScaledWithGraphicsCallback(uint8_t scaleX, uint8_t scaleY,
+    void (*callback)(uint8_t page, uint8_t * strip), uint8_t * strip)
+  {
+    setLayoutScaledWithGraphics(scaleX, scaleY, strip);
+    graphicsCallback = callback;
+  }
+
+  /// @brief Configures this library to use a layout with 16 columns and
+  /// 8 rows of 8x8 tiles.
+  ///
+  /// @param tiles A pointer to the tile images (see PololuSH1106TileSet).
+  ///   This class keeps the pointer, so the tile set must not be a local
+  ///   variable that goes away while the layout is in use.
+  ///
+  /// Each entry in the text buffer holds the number of the tile shown in
+  /// that cell, so you can change the screen with the usual text functions
+  /// (like gotoXY(), write(), and getLinePointer()), and only the cells that
+  /// changed are written to the display.
+  ///
+  /// The text buffer starts out filled with spaces (character 32), and
+  /// clear() fills it with spaces, so you should either define tile 32 or
+  /// fill the text buffer with your own blank tile first.
+  ///
+  /// This lets you draw pictures and icons that cover the whole screen
+  /// without a 1024-byte graphics buffer.  The text buffer only needs to be
+  /// 16x8 (128 bytes) for this layout, so you might want to use
+  /// PololuSH1106Main<C, 16, 8> (see "Text buffer size").
+  ///
+  /// If you change a tile in the RAM tile bank, call markTileDirty() so that
+  /// the next display() writes the cells showing it.
+  void setLayoutTiles(const PololuSH1106TileSet * tiles)
+  {
+    static_assert(textBufferWidth >= 16 && textBufferHeight >= 8,
+      "The text buffer is too small for this layout.");
+    static_assert(!HasFixedLayout::value,
+      "This display has a fixed layout.");
+    this->tileSet = tiles;
+    graphicsBuffer = nullptr;
+    selectLayout(16, 8, &PololuSH1106Main::displayTilesPartial, nullptr,
+      HasFixedLayout());
+    clearDisplayRamOnNextDisplay = true;
+  }
+
+  /// @brief Marks the cells that show the specified tile as dirty, so the
+  /// next display() writes them again.
+  ///
+  /// Call this after changing a tile in the RAM tile bank passed to
+  /// setLayoutTiles().
+  void markTileDirty(uint8_t tile)
+  {
+    markCharacterDirty(tile);
+  }
+
+  /// @brief Returns the number of columns of text shown by the current
+  /// layout.
+  uint8_t getLayoutWidth() { return getLayoutWidth(HasFixedLayout()); }
+
+  /// @brief Returns the number of rows of text shown by the current layout.
+  uint8_t getLayoutHeight() { return getLayoutHeight(HasFixedLayout()); }
+
+private:
+
+  uint8_t getLayoutWidth(PololuOLEDHelpers::BoolConstant<false>)
+  {
+    return this->layoutWidth;
+  }
+
+  uint8_t getLayoutWidth(PololuOLEDHelpers::BoolConstant<true>)
+  {
+    return FixedLayout::width;
+  }
+
+  uint8_t getLayoutHeight(PololuOLEDHelpers::BoolConstant<false>)
+  {
+    return this->layoutHeight;
+  }
+
+  uint8_t getLayoutHeight(PololuOLEDHelpers::BoolConstant<true>)
+  {
+    return FixedLayout::height;
+  }
+
+  // Returns true if the layout functions may select the specified layout:
+  // any layout if this display does not have a fixed layout, or else only
+  // the fixed layout.
+  template <class Layout> static constexpr bool canSelectLayout()
+  {
+    return !HasFixedLayout::value ||
+      PololuOLEDHelpers::IsSame<FixedLayout, Layout>::value;
+  }
+
+  // Stores the geometry and display routines of the selected layout.  A
+  // display with a fixed layout already knows them, so it stores nothing.
+  void selectLayout(uint8_t width, uint8_t height,
+    void (PololuSH1106Main::*partialFunction)(uint8_t, uint8_t, uint8_t),
+    void (PololuSH1106Main::*pagesFunction)(uint8_t, uint8_t),
+    PololuOLEDHelpers::BoolConstant<false>)
+  {
+    this->layoutWidth = width;
+    this->layoutHeight = height;
+    this->displayPartialFunction = partialFunction;
+    this->displayPagesFunction = pagesFunction;
+  }
+
+  void selectLayout(uint8_t, uint8_t,
+    void (PololuSH1106Main::*)(uint8_t, uint8_t, uint8_t),
+    void (PololuSH1106Main::*)(uint8_t, uint8_t),
+    PololuOLEDHelpers::BoolConstant<true>)
+  {
+  }
+
+  // Selects the layout that a new display starts with: the 8x2 layout, or
+  // the fixed layout.
+  void setDefaultLayout(PololuOLEDHelpers::BoolConstant<false>)
+  {
+    setLayout8x2();
+  }
+
+  void setDefaultLayout(PololuOLEDHelpers::BoolConstant<true>)
+  {
+    FixedLayout::select(*this);
+  }
+
+  void setScaledGeometry(uint8_t scaleX, uint8_t scaleY)
+  {
+    if (scaleX < 1) { scaleX = 1; }
+    if (scaleX > 8) { scaleX = 8; }
+    if (scaleY < 1) { scaleY = 1; }
+    if (scaleY > 8) { scaleY = 8; }
+    this->textScaleX = scaleX;
+    this->textScaleY = scaleY;
+    uint8_t width = (128 + scaleX) / (6 * scaleX);
+    if (width > textBufferWidth) { width = textBufferWidth; }
+    uint8_t height = 8 / scaleY;
+    if (height > textBufferHeight) { height = textBufferHeight; }
+    this->layoutWidth = width;
+    this->layoutHeight = height;
+  }
+
+public:
+
+  //////// Display routines
+
+private:
+
+  uint8_t getGlyphColumn(uint8_t glyph, uint8_t pixelX)
   {
     if (glyph >= 0x20)
     {
@@ -347,243 +1316,724 @@ private:
     }
   }
 
-  void writePageGraphics(uint8_t page)
+  // Returns true if the specified page of the display needs to be written,
+  // given the line of text that is shown on it.  In skipUnchangedPages() mode,
+  // this compares a checksum of the graphics and text on the page to the
+  // checksum of what was last written to it, and records the new checksum.
+  bool pageChanged(uint8_t page, const uint8_t * text, uint8_t textLength)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | 0);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | 2);
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128;
-    for (uint8_t x = 0; x < 128; x++) { core.sh1106Write(*g++); }
+    if (!pageSignatures) { return true; }
+
+    uint16_t signature = 0xFFFF;
+    const uint8_t * g = graphicsPage(page);
+    for (uint8_t x = 0; x < 128; x++)
+    {
+      signature = PololuOLEDHelpers::crc16Update(signature, g[x]);
+    }
+    for (uint8_t i = 0; i < textLength; i++)
+    {
+      signature = PololuOLEDHelpers::crc16Update(signature, text[i]);
+    }
+
+    // 0 means that the page has to be written, so no checksum is 0.
+    if (signature == 0) { signature = 1; }
+    if (pageSignatures[page] == signature) { return false; }
+    pageSignatures[page] = signature;
+    return true;
   }
 
-  void writeSegmentUpperText(uint8_t page, uint8_t columnAddr,
-    const uint8_t * text, uint8_t textLength)
+  // Makes the next display() write the pages whose bits are set in the mask
+  // (bit N for page N) in skipUnchangedPages() mode.
+  void forgetPageSignatures(uint8_t pages)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
-    core.sh1106DataMode();
-    for (uint8_t i = 0; i < textLength; i++)
+    if (!pageSignatures) { return; }
+    for (uint8_t page = 0; page < 8; page++)
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
-      {
-        uint8_t column = PololuOLEDHelpers::repeatBits(
-          getGlyphColumn(glyph, pixelX) & 0xF);
-        core.sh1106Write(column);
-        core.sh1106Write(column);
-      }
-      core.sh1106Write(0);
-      core.sh1106Write(0);
+      if (pages >> page & 1) { pageSignatures[page] = 0; }
     }
   }
 
-  void writeSegmentLowerText(uint8_t page, uint8_t columnAddr,
-    const uint8_t * text, uint8_t textLength)
+  // Returns the number of data bytes that take about as long to send as the
+  // commands that start a new run of data with setAddress().  The core can
+  // provide this with sh1106RunCost(); otherwise it is 3, the number of
+  // command bytes.
+  uint8_t coreRunCost()
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
-    core.sh1106DataMode();
-    for (uint8_t i = 0; i < textLength; i++)
+    return coreRunCost(PololuOLEDHelpers::BoolConstant<
+      PololuOLEDHelpers::HasRunCost<C>::value>());
+  }
+
+  uint8_t coreRunCost(PololuOLEDHelpers::BoolConstant<true>)
+  {
+    return core.sh1106RunCost();
+  }
+
+  uint8_t coreRunCost(PololuOLEDHelpers::BoolConstant<false>)
+  {
+    return 3;
+  }
+
+  // Renders a page of a layout with graphics into a 128-byte buffer, compares
+  // it to the shadow buffer, and writes the runs of bytes that changed.  Two
+  // runs are merged into one if the unchanged bytes between them are cheaper
+  // to send again than the commands to start a new run.  The caller must
+  // start and end the transfer.
+  void writePageChanges(uint8_t page, uint8_t runCost)
+  {
+    // The page functions write every column of the page, so the strip does
+    // not need to be filled first (which would run the graphics callback an
+    // extra time).
+    uint8_t strip[128];
+
+    uint16_t * const signatures = pageSignatures;
+    pageSignatures = nullptr;
+    Clip capture = { &PololuSH1106Main::writeClipped, 0, 128, 0, 0, false,
+      strip };
+    clip = &capture;
+    displayLayoutPages(page, page);
+    clip = nullptr;
+    pageSignatures = signatures;
+    forgetPageSignatures(1 << page);
+
+    const uint8_t * const old = shadowPage(page);
+    uint8_t x = 0;
+    while (true)
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
+      while (x < 128 && strip[x] == old[x]) { x++; }
+      if (x == 128) { return; }
+
+      // The run ends before the first gap of runCost unchanged bytes.
+      const uint8_t start = x;
+      uint8_t end = x + 1;
+      for (x = end; x < 128 && (uint8_t)(x - end) < runCost; x++)
       {
-        uint8_t column = PololuOLEDHelpers::repeatBits(
-          getGlyphColumn(glyph, pixelX) >> 4);
-        core.sh1106Write(column);
-        core.sh1106Write(column);
+        if (strip[x] != old[x]) { end = x + 1; }
       }
-      core.sh1106Write(0);
-      core.sh1106Write(0);
+
+      setAddress(page, start);
+      writeBuffer(strip + start, end - start);
+      x = end;
     }
   }
 
-  void writeSegmentUpperTextAndGraphics(uint8_t page, uint8_t columnAddr,
-    const uint8_t * text, uint8_t textLength)
+  // Stored in the shadow buffer by setShadowBuffer() (see
+  // PololuSH1106ShadowBuffer::writePageChanges).
+  static void writePageChangesOf(void * display, uint8_t page,
+    uint8_t runCost)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128 + (columnAddr - 2);
-    for (uint8_t i = 0; i < textLength; i++)
+    static_cast<PololuSH1106Main *>(display)->writePageChanges(page, runCost);
+  }
+
+  // Writes the bytes of every page that changed.  This is used by display()
+  // in layouts with graphics when there is a shadow buffer.
+  void displayChangedBytes()
+  {
+    const uint8_t runCost = coreRunCost();
+    sh1106TransferStart();
+    for (uint8_t page = 0; page < 8; page++)
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
-      {
-        uint8_t column = PololuOLEDHelpers::repeatBits(
-          getGlyphColumn(glyph, pixelX) & 0xF);
-        core.sh1106Write(column ^ *g++);
-        core.sh1106Write(column ^ *g++);
-      }
-      core.sh1106Write(*g++);
-      core.sh1106Write(*g++);
+      shadowBuffer->writePageChanges(this, page, runCost);
     }
+    sh1106TransferEnd();
   }
 
-  void writeSegmentLowerTextAndGraphics(uint8_t page, uint8_t columnAddr,
-    const uint8_t * text, uint8_t textLength)
+  // Values for the halves parameter of writeText().
+  enum
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128 + (columnAddr - 2);
-    for (uint8_t i = 0; i < textLength; i++)
+    upperHalf = 1,
+    lowerHalf = 2,
+    bothHalves = upperHalf | lowerHalf,
+  };
+
+  // Sends the commands to start writing data at the specified page and pixel
+  // column (0 to 127).  While displayGraphicsRect() is writing, this just
+  // records the address, and writeClipped() sends it later if needed.
+  //
+  // The page is relative to the display start line (see
+  // setDisplayStartLine()), so page 0 is always the top page of the screen.
+  void setAddress(uint8_t page, uint8_t x)
+  {
+    if (clip)
+    {
+      clip->page = page;
+      clip->column = x;
+      clip->addressPending = true;
+      return;
+    }
+    const uint8_t columnAddr = x + 2;
+    sh1106CommandMode();
+    sendPendingStartLine();
+    sh1106Write(SH1106_SET_PAGE_ADDR | ((page + (startLine >> 3)) & 7));
+    sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
+    sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
+    sh1106DataMode();
+    if (shadowBuffer && x < 128)
+    {
+      shadowBuffer->cursor = shadowPage(page) + x;
+      shadowBuffer->remaining = 128 - x;
+    }
+  }
+
+  // Returns a pointer to the part of the shadow buffer for the specified
+  // page, counting from the top of the screen.  The shadow buffer is in the
+  // order of the pages in the SH1106's RAM, so it does not change when
+  // setDisplayStartLine() scrolls the screen.
+  uint8_t * shadowPage(uint8_t page)
+  {
+    return shadowBuffer->ram[(page + (startLine >> 3)) & 7];
+  }
+
+  // This template generates all of the routines that write text to the OLED.
+  // It writes a line of text starting at the specified page and pixel column
+  // (0 to 127).  Columns past the right edge of the screen are not written.
+  //
+  // - scale is 1 for 5x8 glyphs or 2 for 10x16 glyphs.
+  // - halves says which half of each 2x glyph to write: upperHalf,
+  //   lowerHalf, or bothHalves.  With bothHalves, the upper half goes to the
+  //   specified page and the lower half goes to the page below it.  Each glyph
+  //   column is only fetched and doubled once: the bytes for the lower page
+  //   are saved on the stack while the upper page is written.
+  // - withGraphics says whether to XOR the text with the graphics buffer.
+  // - fillPage says whether to write the whole width of the page, with
+  //   graphics on both sides of the text.  In that case, x is the width of
+  //   the left margin.
+  //
+  // The position and margin are function arguments, not template parameters:
+  // they are different for each layout, so making them template parameters
+  // would give each layout its own copy of this function.
+  template <uint8_t scale, uint8_t halves, bool withGraphics, bool fillPage>
+  void writeText(uint8_t page, uint8_t x, const uint8_t * text, uint8_t textLength)
+  {
+    uint8_t lowerColumns[halves == bothHalves ? 11 * 5 : 1];
+    const uint8_t startX = fillPage ? 0 : x;
+    const uint8_t pageCount = halves == bothHalves ? 2 : 1;
+    for (uint8_t pass = 0; pass < pageCount; pass++)
     {
-      uint8_t glyph = *text++;
-      // Note the extra check for g < graphicsBuffer + 1023, which avoids
-      // reading past the end of the graphics array in 11x4 mode.
-      for (uint8_t pixelX = 0; pixelX < 5 && g < graphicsBuffer + 1023; pixelX++)
+      setAddress(page + pass, startX);
+      const uint8_t * g = withGraphics ?
+        graphicsPage(page + pass) + startX : nullptr;
+      if (fillPage)
       {
-        uint8_t column = PololuOLEDHelpers::repeatBits(
-          getGlyphColumn(glyph, pixelX) >> 4);
-        core.sh1106Write(column ^ *g++);
-        core.sh1106Write(column ^ *g++);
+        writeBuffer(g, x);
+        g += x;
       }
-      if(g < graphicsBuffer + 1023)
+      uint8_t * lower = lowerColumns;
+      uint8_t pixelX = x;
+      for (uint8_t i = 0; i < textLength; i++)
       {
-        core.sh1106Write(*g++);
-        core.sh1106Write(*g++);
+        const uint8_t glyph = text[i];
+
+        if (scale == 1 && !withGraphics && pixelX <= 128 - 6)
+        {
+          writeGlyph(glyph);
+          writeData(0);
+          pixelX += 6;
+          continue;
+        }
+
+        for (uint8_t glyphX = 0; glyphX < 6; glyphX++)
+        {
+          uint8_t column = 0;
+          if (glyphX < 5)
+          {
+            if (scale == 1)
+            {
+              column = getGlyphColumn(glyph, glyphX);
+            }
+            else if (halves == bothHalves && pass == 1)
+            {
+              column = *lower++;
+            }
+            else
+            {
+              column = getDoubledGlyphColumn<halves>(glyph, glyphX, lower);
+            }
+          }
+          for (uint8_t r = 0; r < scale && pixelX < 128; r++, pixelX++)
+          {
+            writeData(withGraphics ? column ^ *g++ : column);
+          }
+        }
       }
+      if (fillPage && pixelX < 128) { writeBuffer(g, 128 - pixelX); }
     }
   }
 
-  void writePageUpperTextAndGraphics(uint8_t page, const uint8_t * text,
-    uint8_t leftMargin, uint8_t textLength)
+  // Returns one byte of a column of a glyph at 2x scale: the upper half if
+  // halves is upperHalf or bothHalves, or the lower half if halves is
+  // lowerHalf.  With bothHalves, the lower half is also saved to *lower.
+  template <uint8_t halves>
+  uint8_t getDoubledGlyphColumn(uint8_t glyph, uint8_t glyphX, uint8_t * & lower)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | 0);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | 2);
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128;
-    for (uint8_t i = 0; i < leftMargin; i++) { core.sh1106Write(*g++); }
-    for (uint8_t textX = 0; textX < textLength; textX++)
+    const uint8_t column = getGlyphColumn(glyph, glyphX);
+#ifdef POLOLU_OLED_FAST_DOUBLE_TEXT
+    const uint16_t doubled = PololuOLEDHelpers::doubleBitsFromTable(column);
+    if (halves == bothHalves) { *lower++ = doubled >> 8; }
+    return halves == lowerHalf ? doubled >> 8 : doubled;
+#else
+    (void)lower;
+    return PololuOLEDHelpers::repeatBits(
+      halves == lowerHalf ? column >> 4 : column & 0xF);
+#endif
+  }
+
+  // Writes the five columns of a glyph at 1x scale.
+  void writeGlyph(uint8_t glyph)
+  {
+    if (glyph >= 0x20)
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
-      {
-        uint8_t column = PololuOLEDHelpers::repeatBits(
-          getGlyphColumn(glyph, pixelX) & 0xF);
-        core.sh1106Write(column ^ *g++);
-        core.sh1106Write(column ^ *g++);
-       }
-       core.sh1106Write(*g++);
-       core.sh1106Write(*g++);
+      writeBufferFromProgmem(pololuOledFont[glyph - 0x20], 5);
+    }
+    else if (glyph < 8)
+    {
+      writeBuffer(customChars[glyph], 5);
     }
-    for (uint8_t x = leftMargin + textLength * 12; x < 128; x++)
+    else
     {
-      core.sh1106Write(*g++);
+      writeZeros(5);
     }
   }
 
-  void writePageLowerTextAndGraphics(uint8_t page, const uint8_t * text,
-    uint8_t leftMargin, uint8_t textLength)
+  // Writes a line of double-size text with graphics to the full width of the
+  // specified page and/or the page below it, with the text starting at pixel
+  // column leftMargin.
+  void writeDoubleTextAndGraphicsPages(uint8_t page, uint8_t leftMargin,
+    const uint8_t * text, uint8_t textLength, bool upper, bool lower)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | 0);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | 2);
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128;
-    for (uint8_t i = 0; i < leftMargin; i++) { core.sh1106Write(*g++); }
-    for (uint8_t textX = 0; textX < textLength; textX++)
-    {
-      uint8_t glyph = *text++;
-      // Note the extra check for g < graphicsBuffer + 1023, which avoids
-      // reading past the end of the graphics array in 11x4 mode.
-      for (uint8_t pixelX = 0; pixelX < 5 && g < graphicsBuffer + 1023; pixelX++)
-      {
-        uint8_t column = PololuOLEDHelpers::repeatBits(
-          getGlyphColumn(glyph, pixelX) >> 4);
-        core.sh1106Write(column ^ *g++);
-        core.sh1106Write(column ^ *g++);
-       }
-       if(g < graphicsBuffer + 1023)
-       {
-         core.sh1106Write(*g++);
-         core.sh1106Write(*g++);
-       }
+#ifdef POLOLU_OLED_FAST_DOUBLE_TEXT
+    if (upper && lower)
+    {
+      writeText<2, bothHalves, true, true>(page, leftMargin, text, textLength);
+      return;
+    }
+#endif
+    if (upper)
+    {
+      writeText<2, upperHalf, true, true>(page, leftMargin, text, textLength);
     }
-    for (uint8_t x = leftMargin + textLength * 12; x < 128; x++)
+    if (lower)
     {
-      core.sh1106Write(*g++);
+      writeText<2, lowerHalf, true, true>(page + 1, leftMargin, text, textLength);
     }
   }
 
-  void writeSegmentText(uint8_t page, uint8_t columnAddr,
+  // Writes a segment of double-size text, optionally XORed with graphics, to
+  // the specified page and the page below it, starting at pixel column x.
+  template <bool withGraphics>
+  void writeDoubleTextSegment(uint8_t page, uint8_t x,
     const uint8_t * text, uint8_t textLength)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
-    core.sh1106DataMode();
-    for (uint8_t i = 0; i < textLength; i++)
+#ifdef POLOLU_OLED_FAST_DOUBLE_TEXT
+    writeText<2, bothHalves, withGraphics, false>(page, x, text, textLength);
+#else
+    writeText<2, upperHalf, withGraphics, false>(page, x, text, textLength);
+    writeText<2, lowerHalf, withGraphics, false>(page + 1, x, text, textLength);
+#endif
+  }
+
+  // Returns a pointer to the 128 bytes of graphics for the specified page.
+  // With a graphics callback, this clears the strip (which was passed to the
+  // layout function as a non-const pointer) and calls the callback to draw
+  // the page on it.
+  const uint8_t * graphicsPage(uint8_t page)
+  {
+    if (!graphicsCallback) { return graphicsBuffer + page * 128; }
+    uint8_t * const strip = const_cast<uint8_t *>(graphicsBuffer);
+    memset(strip, 0, 128);
+    graphicsCallback(page, strip);
+    return strip;
+  }
+
+  void writePageGraphics(uint8_t page)
+  {
+    setAddress(page, 0);
+    writeBuffer(graphicsPage(page), 128);
+  }
+
+  // Returns a pointer to a line of the text buffer that the display routines
+  // read.
+  uint8_t * frontLine(uint8_t line)
+  {
+    return textBuffer + line * textBufferWidth;
+  }
+
+  // Returns a pointer to the text that the display routines show on the
+  // specified row of the layout.  This is the same as frontLine(), unless
+  // setScrollbackView() is showing lines from the scrollback buffer.
+  uint8_t * textLine(uint8_t line)
+  {
+    const uint8_t view = getScrollbackView();
+    if (line < getLayoutHeight())
+    {
+      if (line < view) { return scrollbackLine(view - line); }
+      line -= view;
+    }
+    return frontLine(line);
+  }
+
+  // Returns a pointer to a line in the scrollback buffer.  1 means the line
+  // that most recently scrolled off the top of the terminal.
+  uint8_t * scrollbackLine(uint8_t age)
+  {
+    const PololuSH1106Scrollback * const s = scrollback;
+    const uint8_t index = s->next >= age ?
+      s->next - age : s->next + s->size - age;
+    return s->lines + index * textBufferWidth;
+  }
+
+  // Returns a pointer to a line of the text that the text functions modify:
+  // the back buffer in double-buffered mode, or else the same as frontLine().
+  uint8_t * editLine(uint8_t line)
+  {
+    uint8_t * const buffer = textBackBuffer ? textBackBuffer : textBuffer;
+    return buffer + line * textBufferWidth;
+  }
+
+  // In double-buffered mode, copies the back buffer to the text buffer read
+  // by the display routines.  Interrupts are disabled during the copy so that
+  // it does not catch a change that is half done.  If clean is true, the dirty
+  // bits are also cleared while interrupts are disabled.
+  void snapshotText(bool clean)
+  {
+    if (!textBackBuffer) { return; }
+    PololuOLEDHelpers::InterruptGuard guard;
+    memcpy(textBuffer, textBackBuffer, sizeof(textBuffer));
+    if (clean) { memset(dirtyCells, 0, sizeof(dirtyCells)); }
+  }
+
+  // Like snapshotText(true), but only for some characters of one line.
+  void snapshotText(uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (!textBackBuffer || y >= textBufferHeight || x >= textBufferWidth) { return; }
+    if (width > (uint8_t)(textBufferWidth - x)) { width = textBufferWidth - x; }
+    PololuOLEDHelpers::InterruptGuard guard;
+    memcpy(frontLine(y) + x, editLine(y) + x, width);
+    setDirty(x, y, width, false);
+  }
+
+  // Called after display() has written all the text.  In double-buffered
+  // mode, the back buffer might have changed while the text was being
+  // written, so this marks the characters that differ between the two
+  // buffers as dirty.  Otherwise, it marks all characters as clean.
+  void markWrittenTextClean()
+  {
+    if (!textBackBuffer)
+    {
+      memset(dirtyCells, 0, sizeof(dirtyCells));
+      return;
+    }
+    PololuOLEDHelpers::InterruptGuard guard;
+    for (uint8_t y = 0; y < textBufferHeight; y++)
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
+      const uint8_t * const front = frontLine(y);
+      const uint8_t * const back = editLine(y);
+      for (uint8_t x = 0; x < textBufferWidth; x++)
       {
-        core.sh1106Write(getGlyphColumn(glyph, pixelX));
+        setDirty(x, y, 1, front[x] != back[x]);
       }
-      core.sh1106Write(0);
     }
   }
 
-  void writeSegmentTextAndGraphics(uint8_t page, uint8_t columnAddr,
-    const uint8_t * text, uint8_t textLength)
+  void initCustomChars(PololuOLEDHelpers::BoolConstant<false>)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | (columnAddr >> 4));
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | (columnAddr & 0xF));
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128 + (columnAddr - 2);
-    for (uint8_t i = 0; i < textLength; i++)
+    memset(customChars, 0, sizeof(customChars));
+  }
+
+  // The PololuSH1106Multi that owns this display sets the pointer.
+  void initCustomChars(PololuOLEDHelpers::BoolConstant<true>)
+  {
+    customChars = nullptr;
+  }
+
+  // Makes the next update show the new dot pattern of a custom character.
+  void customCharacterChanged(uint8_t number)
+  {
+    forgetPageSignatures(0xFF);
+    markCharacterDirty(number);
+  }
+
+  // Marks every cell of the text buffer that holds the specified character
+  // as dirty.
+  void markCharacterDirty(uint8_t c)
+  {
+    for (uint8_t y = 0; y < textBufferHeight; y++)
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
+      const uint8_t * line = editLine(y);
+      for (uint8_t x = 0; x < textBufferWidth; x++)
       {
-        core.sh1106Write(getGlyphColumn(glyph, pixelX) ^ *g++);
+        if (line[x] == c) { setDirty(x, y, 1, true); }
       }
-      core.sh1106Write(*g++);
     }
   }
 
-  void writePageTextAndGraphics(uint8_t page, const uint8_t * text,
-    uint8_t leftMargin, uint8_t textLength)
+  bool isDirty(uint8_t x, uint8_t y)
   {
-    core.sh1106CommandMode();
-    core.sh1106Write(SH1106_SET_PAGE_ADDR | page);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_HIGH | 0);
-    core.sh1106Write(SH1106_SET_COLUMN_ADDR_LOW | 2);
-    core.sh1106DataMode();
-    const uint8_t * g = graphicsBuffer + page * 128;
-    for (uint8_t i = 0; i < leftMargin; i++) { core.sh1106Write(*g++); }
-    for (uint8_t textX = 0; textX < textLength; textX++)
+    return dirtyCells[y][x >> 3] >> (x & 7) & 1;
+  }
+
+  void setDirty(uint8_t x, uint8_t y, uint8_t width, bool dirty)
+  {
+    if (y >= textBufferHeight) { return; }
+    for (; width && x < textBufferWidth; x++, width--)
+    {
+      const uint8_t mask = 1 << (x & 7);
+      if (dirty) { dirtyCells[y][x >> 3] |= mask; }
+      else { dirtyCells[y][x >> 3] &= ~mask; }
+    }
+  }
+
+  // Stores a character in the text buffer and marks it as dirty if it
+  // changed.  Returns true if it changed.
+  bool storeCharacter(uint8_t x, uint8_t y, uint8_t c)
+  {
+    uint8_t * p = editLine(y) + x;
+    if (*p == c) { return false; }
+    *p = c;
+    setDirty(x, y, 1, true);
+    return true;
+  }
+
+  // Returns true if text changes should be written to the OLED right away.
+  bool autoDisplayNow()
+  {
+    return !disableAutoDisplay && updateDepth == 0;
+  }
+
+  // This is the display function for layouts without a graphics buffer.
+  // It writes each run of dirty characters with the layout's partial display
+  // function, all in one transfer.  Lines that use the font set by setFont()
+  // or setCompressedFont() are written with one call from the first dirty
+  // character to the last, because writeFontLine() writes everything after
+  // the first character it is given.
+  void displayChangedText()
+  {
+    sh1106TransferStart();
+    for (uint8_t y = 0; y < textBufferHeight; y++)
+    {
+      if (lineUsesFont(y))
+      {
+        uint8_t first, width;
+        if (findDirtySpan(y, first, width))
+        {
+          displayLayoutPartial(first, y, width);
+        }
+        continue;
+      }
+
+      uint8_t x = 0;
+      while (x < textBufferWidth)
+      {
+        if (!isDirty(x, y)) { x++; continue; }
+        const uint8_t start = x;
+        while (x < textBufferWidth && isDirty(x, y)) { x++; }
+        displayLayoutPartial(start, y, x - start);
+      }
+    }
+    sh1106TransferEnd();
+  }
+
+  // Writes part of a line of text with the partial display routine of the
+  // current layout.
+  void displayLayoutPartial(uint8_t x, uint8_t y, uint8_t width)
+  {
+    displayLayoutPartial(x, y, width, HasFixedLayout());
+  }
+
+  void displayLayoutPartial(uint8_t x, uint8_t y, uint8_t width,
+    PololuOLEDHelpers::BoolConstant<false>)
+  {
+    ((*this).*(this->displayPartialFunction))(x, y, width);
+  }
+
+  void displayLayoutPartial(uint8_t x, uint8_t y, uint8_t width,
+    PololuOLEDHelpers::BoolConstant<true>)
+  {
+    displayFixedLayoutPartial(FixedLayout(), x, y, width);
+  }
+
+  void displayFixedLayoutPartial(PololuSH1106Layout8x2,
+    uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (graphicsBuffer) { display8x2TextAndGraphicsPartial(x, y, width); }
+    else { display8x2TextPartial(x, y, width); }
+  }
+
+  void displayFixedLayoutPartial(PololuSH1106Layout11x4,
+    uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (graphicsBuffer) { display11x4TextAndGraphicsPartial(x, y, width); }
+    else { display11x4TextPartial(x, y, width); }
+  }
+
+  void displayFixedLayoutPartial(PololuSH1106Layout21x8,
+    uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (graphicsBuffer) { display21x8TextAndGraphicsPartial(x, y, width); }
+    else { display21x8TextPartial(x, y, width); }
+  }
+
+  // Writes the pages from firstPage to lastPage of a layout with graphics,
+  // skipping the ones that skipUnchangedPages() knows did not change.  The
+  // caller must start and end the transfer.
+  void displayLayoutPages(uint8_t firstPage, uint8_t lastPage)
+  {
+    displayLayoutPages(firstPage, lastPage, HasFixedLayout());
+  }
+
+  void displayLayoutPages(uint8_t firstPage, uint8_t lastPage,
+    PololuOLEDHelpers::BoolConstant<false>)
+  {
+    ((*this).*(this->displayPagesFunction))(firstPage, lastPage);
+  }
+
+  void displayLayoutPages(uint8_t firstPage, uint8_t lastPage,
+    PololuOLEDHelpers::BoolConstant<true>)
+  {
+    displayFixedLayoutPages(FixedLayout(), firstPage, lastPage);
+  }
+
+  void displayFixedLayoutPages(PololuSH1106Layout8x2,
+    uint8_t firstPage, uint8_t lastPage)
+  {
+    display8x2TextAndGraphicsPages(firstPage, lastPage);
+  }
+
+  void displayFixedLayoutPages(PololuSH1106Layout11x4,
+    uint8_t firstPage, uint8_t lastPage)
+  {
+    display11x4TextAndGraphicsPages(firstPage, lastPage);
+  }
+
+  void displayFixedLayoutPages(PololuSH1106Layout21x8,
+    uint8_t firstPage, uint8_t lastPage)
+  {
+    display21x8TextAndGraphicsPages(firstPage, lastPage);
+  }
+
+  // Finds the characters of the specified line of text from the first dirty
+  // one to the last dirty one.  Returns false if there are no dirty
+  // characters in the line.
+  bool findDirtySpan(uint8_t y, uint8_t & first, uint8_t & width)
+  {
+    if (!lineDirty(y)) { return false; }
+    first = 0xFF;
+    uint8_t last = 0;
+    for (uint8_t x = 0; x < textBufferWidth; x++)
+    {
+      if (isDirty(x, y))
+      {
+        if (first == 0xFF) { first = x; }
+        last = x;
+      }
+    }
+    if (first == 0xFF) { return false; }
+    width = last - first + 1;
+    return true;
+  }
+
+  // Writes the characters of the specified line of text from the first dirty
+  // one to the last dirty one with a single partial update.  Returns false if
+  // there are no dirty characters in the line.
+  bool displayDirtySpan(uint8_t y)
+  {
+    uint8_t first, width;
+    if (!findDirtySpan(y, first, width)) { return false; }
+    displayPartial(first, y, width);
+    return true;
+  }
+
+  // Starts an update that is written one part at a time by
+  // displayNextFramePart(): a page for layouts with graphics, or a changed
+  // line of text for other layouts.  This is used by displayAsync() and
+  // displayStep().
+  void startFrame(void (*callback)())
+  {
+    init();
+    if (clearDisplayRamOnNextDisplay) { clearDisplayRam(); }
+    if (graphicsBuffer)
+    {
+      if (textBackBuffer)
+      {
+        snapshotText(true);
+      }
+      else
+      {
+        memset(dirtyCells, 0, sizeof(dirtyCells));
+      }
+    }
+    disableAutoDisplay = false;
+    framePosition = 0;
+    frameCallback = callback;
+  }
+
+  // Returns true if any character in the specified line of text is dirty.
+  bool lineDirty(uint8_t y)
+  {
+    for (uint8_t i = 0; i < sizeof(dirtyCells[0]); i++)
+    {
+      if (dirtyCells[y][i]) { return true; }
+    }
+    return false;
+  }
+
+  // Returns true if the current update has more to write.  For layouts
+  // without graphics, this skips over lines of text that have not changed.
+  bool frameRemaining()
+  {
+    if (graphicsBuffer) { return framePosition < 8; }
+    while (framePosition < textBufferHeight && !lineDirty(framePosition))
     {
-      uint8_t glyph = *text++;
-      for (uint8_t pixelX = 0; pixelX < 5; pixelX++)
+      framePosition++;
+    }
+    return framePosition < textBufferHeight;
+  }
+
+  // Writes the next part of the current update.  Only call this if
+  // frameRemaining() returned true.
+  void displayNextFramePart()
+  {
+    if (graphicsBuffer)
+    {
+      sh1106TransferStart();
+      if (shadowBuffer)
+      {
+        shadowBuffer->writePageChanges(this, framePosition++, coreRunCost());
+      }
+      else
       {
-        core.sh1106Write(getGlyphColumn(glyph, pixelX) ^ *g++);
-       }
-       core.sh1106Write(*g++);
+        displayLayoutPages(framePosition, framePosition);
+        framePosition++;
+      }
+      sh1106TransferEnd();
     }
-    for (uint8_t x = leftMargin + textLength * 6; x < 128; x++)
+    else
+    {
+      displayDirtySpan(framePosition++);
+    }
+  }
+
+  void endFrame()
+  {
+    framePosition = noFrame;
+    if (frameCallback)
     {
-      core.sh1106Write(*g++);
+      void (*callback)() = frameCallback;
+      frameCallback = nullptr;
+      callback();
     }
   }
 
+  void displayAsync(void (*callback)(), PololuOLEDHelpers::BoolConstant<true>)
+  {
+    startFrame(callback);
+    isBusy();
+  }
+
+  void displayAsync(void (*callback)(), PololuOLEDHelpers::BoolConstant<false>)
+  {
+    display();
+    if (callback) { callback(); }
+  }
 
   //// 8x2 layout //////////////////////////////////////////////////////////////
   // Character size:                 10x16
@@ -599,23 +2049,11 @@ private:
     if (width == 0) { return; }
 
     const uint8_t page = 2 + y * 3;
-    const uint8_t columnAddr = 2 + 17 + x * 12;
-    const uint8_t * const text = getLinePointer(y) + x;
-
-    core.sh1106TransferStart();
-    writeSegmentUpperText(page, columnAddr, text, width);
-    writeSegmentLowerText(page + 1, columnAddr, text, width);
-    core.sh1106TransferEnd();
-  }
+    const uint8_t * const text = textLine(y) + x;
 
-  void display8x2Text()
-  {
-    core.sh1106TransferStart();
-    writeSegmentUpperText(2, 2 + 17, getLinePointer(0), 8);
-    writeSegmentLowerText(3, 2 + 17, getLinePointer(0), 8);
-    writeSegmentUpperText(5, 2 + 17, getLinePointer(1), 8);
-    writeSegmentLowerText(6, 2 + 17, getLinePointer(1), 8);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    writeDoubleTextSegment<false>(page, 17 + x * 12, text, width);
+    sh1106TransferEnd();
   }
 
   void display8x2TextAndGraphicsPartial(uint8_t x, uint8_t y, uint8_t width)
@@ -625,34 +2063,52 @@ private:
     if (width == 0) { return; }
 
     const uint8_t page = 2 + y * 3;
-    const uint8_t columnAddr = 2 + 17 + x * 12;
-    uint8_t * const text = getLinePointer(y) + x;
+    const uint8_t * const text = textLine(y) + x;
+    forgetPageSignatures(3 << page);
 
-    core.sh1106TransferStart();
-    writeSegmentUpperTextAndGraphics(page, columnAddr, text, width);
-    writeSegmentLowerTextAndGraphics(page + 1, columnAddr, text, width);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    writeDoubleTextSegment<true>(page, 17 + x * 12, text, width);
+    sh1106TransferEnd();
   }
 
-  void display8x2TextAndGraphics()
+  // Writes the pages from firstPage to lastPage of the 8x2 layout with
+  // graphics.  Both pages of a line of text are written together when they
+  // are both in the range.  The caller must start and end the transfer.
+  void display8x2TextAndGraphicsPages(uint8_t firstPage, uint8_t lastPage)
   {
-    core.sh1106TransferStart();
-    writePageGraphics(0);
-    writePageGraphics(1);
-    writePageUpperTextAndGraphics(2, getLinePointer(0), 17, 8);
-    writePageLowerTextAndGraphics(3, getLinePointer(0), 17, 8);
-    writePageGraphics(4);
-    writePageUpperTextAndGraphics(5, getLinePointer(1), 17, 8);
-    writePageLowerTextAndGraphics(6, getLinePointer(1), 17, 8);
-    writePageGraphics(7);
-    core.sh1106TransferEnd();
+    for (uint8_t page = firstPage; page <= lastPage; page++)
+    {
+      if (page == 2 || page == 5)
+      {
+        const uint8_t * const text = textLine(page == 2 ? 0 : 1);
+        const bool both = page < lastPage;
+        const bool upper = pageChanged(page, text, 8);
+        const bool lower = both && pageChanged(page + 1, text, 8);
+        writeDoubleTextAndGraphicsPages(page, 17, text, 8, upper, lower);
+        if (both) { page++; }
+      }
+      else if (page == 3 || page == 6)
+      {
+        const uint8_t * const text = textLine(page == 3 ? 0 : 1);
+        if (pageChanged(page, text, 8))
+        {
+          writeDoubleTextAndGraphicsPages(page - 1, 17, text, 8, false, true);
+        }
+      }
+      else if (pageChanged(page, nullptr, 0))
+      {
+        writePageGraphics(page);
+      }
+    }
   }
 
   //// 11x4 layout /////////////////////////////////////////////////////////////
   //   Character size:               10x16
   //   Character horizontal margin:  2
   //   Screen left margin:           0
-  //   Screen right margin:          -2  (or 10 if you don't use the last column; off center: more room for graphics)
+  //   Screen right margin:          -2  (or 10 if you don't use the last
+  //                                 column; off center: more room for
+  //                                 graphics)
   //   Line 0:                       pages 0 and 1
   //   Line 1:                       pages 2 and 3
   //   Line 3:                       pages 4 and 5
@@ -665,27 +2121,11 @@ private:
     if (width == 0) { return; }
 
     const uint8_t page = y * 2;
-    const uint8_t columnAddr = 2 + x * 12;
-    const uint8_t * const textStart = getLinePointer(y) + x;
-
-    core.sh1106TransferStart();
-    writeSegmentUpperText(page, columnAddr, textStart, width);
-    writeSegmentLowerText(page + 1, columnAddr, textStart, width);
-    core.sh1106TransferEnd();
-  }
+    const uint8_t * const textStart = textLine(y) + x;
 
-  void display11x4Text()
-  {
-    core.sh1106TransferStart();
-    writeSegmentUpperText(0, 2, getLinePointer(0), 11);
-    writeSegmentLowerText(1, 2, getLinePointer(0), 11);
-    writeSegmentUpperText(2, 2, getLinePointer(1), 11);
-    writeSegmentLowerText(3, 2, getLinePointer(1), 11);
-    writeSegmentUpperText(4, 2, getLinePointer(2), 11);
-    writeSegmentLowerText(5, 2, getLinePointer(2), 11);
-    writeSegmentUpperText(6, 2, getLinePointer(3), 11);
-    writeSegmentLowerText(7, 2, getLinePointer(3), 11);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    writeDoubleTextSegment<false>(page, x * 12, textStart, width);
+    sh1106TransferEnd();
   }
 
   void display11x4TextAndGraphicsPartial(uint8_t x, uint8_t y, uint8_t width)
@@ -695,27 +2135,36 @@ private:
     if (width == 0) { return; }
 
     const uint8_t page = y * 2;
-    const uint8_t columnAddr = 2 + x * 12;
-    uint8_t * const text = getLinePointer(y) + x;
+    const uint8_t * const text = textLine(y) + x;
+    forgetPageSignatures(3 << page);
 
-    core.sh1106TransferStart();
-    writeSegmentUpperTextAndGraphics(page, columnAddr, text, width);
-    writeSegmentLowerTextAndGraphics(page + 1, columnAddr, text, width);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    writeDoubleTextSegment<true>(page, x * 12, text, width);
+    sh1106TransferEnd();
   }
 
-  void display11x4TextAndGraphics()
+  // Writes the pages from firstPage to lastPage of the 11x4 layout with
+  // graphics.  Both pages of a line of text are written together when they
+  // are both in the range.  The caller must start and end the transfer.
+  void display11x4TextAndGraphicsPages(uint8_t firstPage, uint8_t lastPage)
   {
-    core.sh1106TransferStart();
-    writePageUpperTextAndGraphics(0, getLinePointer(0), 0, 11);
-    writePageLowerTextAndGraphics(1, getLinePointer(0), 0, 11);
-    writePageUpperTextAndGraphics(2, getLinePointer(1), 0, 11);
-    writePageLowerTextAndGraphics(3, getLinePointer(1), 0, 11);
-    writePageUpperTextAndGraphics(4, getLinePointer(2), 0, 11);
-    writePageLowerTextAndGraphics(5, getLinePointer(2), 0, 11);
-    writePageUpperTextAndGraphics(6, getLinePointer(3), 0, 11);
-    writePageLowerTextAndGraphics(7, getLinePointer(3), 0, 11);
-    core.sh1106TransferEnd();
+    for (uint8_t page = firstPage; page <= lastPage; page++)
+    {
+      const uint8_t * const text = textLine(page >> 1);
+      if (page & 1)
+      {
+        if (pageChanged(page, text, 11))
+        {
+          writeDoubleTextAndGraphicsPages(page - 1, 0, text, 11, false, true);
+        }
+        continue;
+      }
+      const bool both = page < lastPage;
+      const bool upper = pageChanged(page, text, 11);
+      const bool lower = both && pageChanged(page + 1, text, 11);
+      writeDoubleTextAndGraphicsPages(page, 0, text, 11, upper, lower);
+      if (both) { page++; }
+    }
   }
 
   //// 21x8 layout /////////////////////////////////////////////////////////////
@@ -727,76 +2176,539 @@ private:
 
   void display21x8TextPartial(uint8_t x, uint8_t y, uint8_t width)
   {
+    if (lineUsesFont(y))
+    {
+      sh1106TransferStart();
+      fontLineFunction(*this, y, x, width);
+      sh1106TransferEnd();
+      return;
+    }
     if (x >= 21 || y >= 8) { return; }
     if (width > (uint8_t)(21 - x)) { width = 21 - x; }
     if (width == 0) { return; }
 
-    const uint8_t columnAddr = 2 + x * 6;
-    const uint8_t * const textStart = getLinePointer(y) + x;
+    const uint8_t * const textStart = textLine(y) + x;
 
-    core.sh1106TransferStart();
-    writeSegmentText(y, columnAddr, textStart, width);
-    core.sh1106TransferEnd();
+    sh1106TransferStart();
+    writeText<1, upperHalf, false, false>(y, x * 6, textStart, width);
+    sh1106TransferEnd();
+  }
+
+  void display21x8TextAndGraphicsPartial(uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (lineUsesFont(y))
+    {
+      forgetPageSignatures(1 << y);
+      sh1106TransferStart();
+      fontLineFunction(*this, y, x, width);
+      sh1106TransferEnd();
+      return;
+    }
+    if (x >= 21 || y >= 8) { return; }
+    if (width > (uint8_t)(21 - x)) { width = 21 - x; }
+    if (width == 0) { return; }
+
+    const uint8_t * const text = textLine(y) + x;
+    forgetPageSignatures(1 << y);
+
+    sh1106TransferStart();
+    writeText<1, upperHalf, true, false>(y, x * 6, text, width);
+    sh1106TransferEnd();
+  }
+
+  // Writes the pages from firstPage to lastPage of the 21x8 layout with
+  // graphics.  The caller must start and end the transfer.
+  void display21x8TextAndGraphicsPages(uint8_t firstPage, uint8_t lastPage)
+  {
+    for (uint8_t page = firstPage; page <= lastPage; page++)
+    {
+      display21x8TextAndGraphicsPage(page);
+    }
+  }
+
+  // Writes one page of the 21x8 layout with graphics.
+  void display21x8TextAndGraphicsPage(uint8_t page)
+  {
+    if (lineUsesFont(page))
+    {
+      if (pageChanged(page, textLine(page), textBufferWidth))
+      {
+        fontLineFunction(*this, page, 0, textBufferWidth);
+      }
+      return;
+    }
+    if (pageChanged(page, textLine(page), 21))
+    {
+      writeText<1, upperHalf, true, true>(page, 0, textLine(page), 21);
+    }
+  }
+
+  // Returns true if the specified line of the 21x8 layouts uses the font set
+  // by setFont() or setCompressedFont().
+  bool lineUsesFont(uint8_t line)
+  {
+    return line < 8 && (fontLines >> line & 1);
+  }
+
+  // Writes a line of the 21x8 layouts with the font set by setFont(), from
+  // the specified character to the right edge of the screen.  The position of
+  // each glyph depends on the widths of the glyphs before it, so everything
+  // after the first character that changed has to be written, and the count
+  // of characters that changed is not used.  The caller must start and end the
+  // transfer.
+  void writeFontLine(uint8_t line, uint8_t first, uint8_t)
+  {
+    const uint8_t * const text = textLine(line);
+    const uint8_t * const graphics =
+      graphicsBuffer ? graphicsPage(line) : nullptr;
+
+    uint16_t start = 0;
+    for (uint8_t i = 0; i < first && i < textBufferWidth && start < 128; i++)
+    {
+      start += getFontGlyphWidth(text[i]) + textFont->spacing;
+    }
+    if (start >= 128) { return; }
+
+    uint8_t x = start;
+    setAddress(line, x);
+    for (uint8_t i = first; i < textBufferWidth && x < 128; i++)
+    {
+      const uint8_t glyph = text[i];
+      const uint8_t glyphWidth = getFontGlyphWidth(glyph);
+      const uint8_t cellWidth = glyphWidth + textFont->spacing;
+      const uint8_t * const columns = getFontGlyphColumns(glyph);
+      for (uint8_t glyphX = 0; glyphX < cellWidth && x < 128; glyphX++)
+      {
+        uint8_t column = 0;
+        if (glyphX < glyphWidth)
+        {
+          column = columns ? pgm_read_byte(columns + glyphX) :
+            getGlyphColumn(glyph, glyphX);
+        }
+        if (graphics) { column ^= graphics[x]; }
+        writeData(column);
+        x++;
+      }
+    }
+
+    if (x < 128)
+    {
+      if (graphics) { writeBuffer(graphics + x, 128 - x); }
+      else { writeZeros(128 - x); }
+    }
+  }
+
+  // Returns the width of a glyph in the font set by setFont().  Characters
+  // that are not in the font are drawn with the built-in font.
+  uint8_t getFontGlyphWidth(uint8_t glyph)
+  {
+    if (glyph < textFont->firstChar || glyph > textFont->lastChar) { return 5; }
+    return pgm_read_byte(textFont->widths + (glyph - textFont->firstChar));
+  }
+
+  // Returns a pointer to the columns of a glyph in the font set by setFont(),
+  // or nullptr if the glyph is not in the font.
+  const uint8_t * getFontGlyphColumns(uint8_t glyph)
+  {
+    if (glyph < textFont->firstChar || glyph > textFont->lastChar) { return nullptr; }
+    const uint8_t index = glyph - textFont->firstChar;
+    return textFont->columns + pgm_read_word(textFont->offsets + index);
+  }
+
+  // Writes the specified characters of a line of the 21x8 layouts with the
+  // font set by setCompressedFont(), decoding the glyphs as they are sent.
+  // The rest of the line is cleared when the characters reach the end of the
+  // text buffer.  The caller must start and end the transfer.
+  void writeCompressedFontLine(uint8_t line, uint8_t first, uint8_t count)
+  {
+    const PololuOLEDCompressedFont * const font = compressedFont;
+    const uint8_t * const text = textLine(line);
+    const uint8_t * const graphics =
+      graphicsBuffer ? graphicsPage(line) : nullptr;
+    const uint8_t glyphWidth = font->width;
+    const uint8_t cellWidth = glyphWidth + font->spacing;
+
+    uint16_t end = first + count;
+    if (end > textBufferWidth) { end = textBufferWidth; }
+    uint16_t x = first * cellWidth;
+    if (x >= 128) { return; }
+
+    setAddress(line, x);
+    for (uint8_t i = first; i < end && x < 128; i++)
+    {
+      const uint8_t glyph = text[i];
+      const bool inFont = glyph >= font->firstChar && glyph <= font->lastChar;
+      uint16_t position =
+        inFont ? findCompressedGlyph(glyph - font->firstChar) : 0;
+      for (uint8_t glyphX = 0; glyphX < cellWidth && x < 128; glyphX++)
+      {
+        uint8_t column = 0;
+        if (glyphX < glyphWidth)
+        {
+          if (inFont) { column = readCompressedColumn(position); }
+          else if (glyphX < 5) { column = getGlyphColumn(glyph, glyphX); }
+        }
+        if (graphics) { column ^= graphics[x]; }
+        writeData(column);
+        x++;
+      }
+    }
+
+    if (end == textBufferWidth && x < 128)
+    {
+      if (graphics) { writeBuffer(graphics + x, 128 - x); }
+      else { writeZeros(128 - x); }
+    }
+  }
+
+  // Stored in fontLineFunction by setFont() and setCompressedFont().
+  static void writeFontLineOf(PololuSH1106Main & display, uint8_t line,
+    uint8_t first, uint8_t count)
+  {
+    display.writeFontLine(line, first, count);
+  }
+
+  static void writeCompressedFontLineOf(PololuSH1106Main & display,
+    uint8_t line, uint8_t first, uint8_t count)
+  {
+    display.writeCompressedFontLine(line, first, count);
+  }
+
+  // Returns the position, in nibbles, of the first column of a glyph in the
+  // font set by setCompressedFont().  index is the glyph's position in the
+  // font.
+  uint16_t findCompressedGlyph(uint8_t index)
+  {
+    const PololuOLEDCompressedFont * const font = compressedFont;
+    const uint8_t group = index >> font->groupShift;
+    uint16_t position = pgm_read_word(font->groupOffsets + group);
+    uint8_t glyphs = index - (group << font->groupShift);
+    for (uint16_t n = glyphs * font->width; n; n--)
+    {
+      const uint8_t code = readCompressedNibble(position);
+      position += code < font->shortCodes ? 1 : code < 15 ? 2 : 3;
+    }
+    return position;
+  }
+
+  uint8_t readCompressedNibble(uint16_t position)
+  {
+    const uint8_t byte = pgm_read_byte(compressedFont->codes + (position >> 1));
+    return position & 1 ? byte >> 4 : byte & 15;
+  }
+
+  // Decodes the column at the specified position in the font set by
+  // setCompressedFont(), and advances the position to the next column.
+  uint8_t readCompressedColumn(uint16_t & position)
+  {
+    const PololuOLEDCompressedFont * const font = compressedFont;
+    const uint8_t code = readCompressedNibble(position++);
+    if (code < font->shortCodes)
+    {
+      return pgm_read_byte(font->dictionary + code);
+    }
+    const uint8_t next = readCompressedNibble(position++);
+    if (code < 15)
+    {
+      const uint8_t index = (code - font->shortCodes) << 4 | next;
+      return pgm_read_byte(font->dictionary + font->shortCodes + index);
+    }
+    return next | readCompressedNibble(position++) << 4;
+  }
+
+  //// Scaled layout ///////////////////////////////////////////////////////////
+  //   Character size:              (5 * textScaleX)x(8 * textScaleY)
+  //   Character horizontal margin:  textScaleX
+  //   Lines:                        textScaleY pages each, centered vertically
+  //   Columns:                      centered horizontally
+
+  uint8_t scaledLeftMargin()
+  {
+    return (128 - (this->layoutWidth * 6 - 1) * this->textScaleX) / 2;
+  }
+
+  uint8_t scaledTopPage()
+  {
+    return (8 - this->layoutHeight * this->textScaleY) / 2;
+  }
+
+  // Stretches a glyph column vertically by textScaleY and returns the 8 bits
+  // of the result that go on the specified page of the line (0 for the top).
+  uint8_t scaleGlyphColumn(uint8_t column, uint8_t part)
+  {
+    uint8_t sourceBit = part * 8 / this->textScaleY;
+    uint8_t repeat = part * 8 % this->textScaleY;
+    uint8_t result = 0;
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+      if (column >> sourceBit & 1) { result |= 1 << bit; }
+      if (++repeat == this->textScaleY) { repeat = 0; sourceBit++; }
+    }
+    return result;
+  }
+
+  // Writes one page of a line of scaled text, starting at pixel column x
+  // (0 to 127), and returns the column after the last one written.  Each
+  // glyph is stretched and sent as one run of bytes, so no frame buffer is
+  // needed.  With graphics, the text is XORed with graphics, which points to
+  // the 128 columns of graphics for the page.  The caller must set the
+  // address first.
+  template <bool withGraphics>
+  uint8_t writeScaledText(const uint8_t * graphics, uint8_t part, uint8_t x,
+    const uint8_t * text, uint8_t textLength)
+  {
+    uint8_t cell[6 * 8];
+    for (uint8_t i = 0; i < textLength && x < 128; i++)
+    {
+      uint8_t length = 0;
+      for (uint8_t glyphX = 0; glyphX < 6; glyphX++)
+      {
+        const uint8_t column = glyphX < 5 ?
+          scaleGlyphColumn(getGlyphColumn(text[i], glyphX), part) : 0;
+        for (uint8_t j = 0; j < this->textScaleX; j++)
+        {
+          cell[length++] = column;
+        }
+      }
+      if (length > (uint8_t)(128 - x)) { length = 128 - x; }
+      if (withGraphics)
+      {
+        for (uint8_t j = 0; j < length; j++) { cell[j] ^= graphics[x + j]; }
+      }
+      writeBuffer(cell, length);
+      x += length;
+    }
+    return x;
+  }
+
+  template <bool withGraphics>
+  void displayScaledTextPartial(uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (x >= this->layoutWidth || y >= this->layoutHeight) { return; }
+    if (width > (uint8_t)(this->layoutWidth - x))
+    {
+      width = this->layoutWidth - x;
+    }
+    if (width == 0) { return; }
+
+    const uint8_t * const text = textLine(y) + x;
+    const uint8_t firstPage = scaledTopPage() + y * this->textScaleY;
+    const uint8_t left = scaledLeftMargin() + x * 6 * this->textScaleX;
+    if (withGraphics)
+    {
+      forgetPageSignatures(((1 << this->textScaleY) - 1) << firstPage);
+    }
+
+    sh1106TransferStart();
+    for (uint8_t part = 0; part < this->textScaleY; part++)
+    {
+      setAddress(firstPage + part, left);
+      writeScaledText<withGraphics>(
+        withGraphics ? graphicsPage(firstPage + part) : nullptr,
+        part, left, text, width);
+    }
+    sh1106TransferEnd();
+  }
+
+  // Writes the pages from firstPage to lastPage of the scaled layout with
+  // graphics.  The caller must start and end the transfer.
+  void displayScaledTextAndGraphicsPages(uint8_t firstPage, uint8_t lastPage)
+  {
+    for (uint8_t page = firstPage; page <= lastPage; page++)
+    {
+      displayScaledTextAndGraphicsPage(page);
+    }
+  }
+
+  // Writes one page of the scaled layout with graphics.
+  void displayScaledTextAndGraphicsPage(uint8_t page)
+  {
+    const uint8_t offset = page - scaledTopPage();
+    const uint8_t line = offset / this->textScaleY;
+    if (line >= this->layoutHeight)
+    {
+      if (pageChanged(page, nullptr, 0)) { writePageGraphics(page); }
+      return;
+    }
+
+    const uint8_t * const text = textLine(line);
+    if (!pageChanged(page, text, this->layoutWidth)) { return; }
+    const uint8_t * const graphics = graphicsPage(page);
+    const uint8_t left = scaledLeftMargin();
+    setAddress(page, 0);
+    writeBuffer(graphics, left);
+    const uint8_t right = writeScaledText<true>(graphics,
+      offset - line * this->textScaleY, left, text, this->layoutWidth);
+    writeBuffer(graphics + right, 128 - right);
+  }
+
+  //// Tile layout /////////////////////////////////////////////////////////////
+  //   Tile size:                    8x8
+  //   Screen margins:               0
+  //   Row number = Page number
+
+  // Writes the 8 columns of a tile.  The caller must set the address first.
+  void writeTile(uint8_t tile)
+  {
+    const PololuSH1106TileSet * const t = this->tileSet;
+    const uint8_t ramTileCount = t->ramTiles ? t->ramTileCount : 0;
+    if (tile < ramTileCount)
+    {
+      writeBuffer(t->ramTiles + tile * 8, 8);
+    }
+    else
+    {
+      writeBufferFromProgmem(t->tiles + (tile - ramTileCount) * 8, 8);
+    }
+  }
+
+  void displayTilesPartial(uint8_t x, uint8_t y, uint8_t width)
+  {
+    if (x >= 16 || y >= 8) { return; }
+    if (width > (uint8_t)(16 - x)) { width = 16 - x; }
+    if (width == 0) { return; }
+
+    const uint8_t * const tiles = textLine(y) + x;
+
+    sh1106TransferStart();
+    setAddress(y, x * 8);
+    for (uint8_t i = 0; i < width; i++) { writeTile(tiles[i]); }
+    sh1106TransferEnd();
+  }
+
+public:
+
+  /// @brief Writes the text/graphics that changed to the OLED.
+  ///
+  /// This also turns on auto display mode, undoing the effect of
+  /// noAutoDisplay().
+  ///
+  /// In layouts without a graphics buffer, this only writes the characters
+  /// that are marked as dirty, which are the ones that changed since they
+  /// were last written (see markDirty() and markAllDirty()), all in one
+  /// transfer.  In layouts with a graphics buffer, it writes every page of
+  /// the screen, unless skipUnchangedPages() or setShadowBuffer() is used.
+  void display()
+  {
+#ifdef POLOLU_OLED_STATS
+    const uint32_t startMicros = micros();
+#endif
+    init();
+    if (clearDisplayRamOnNextDisplay) { clearDisplayRam(); }
+    snapshotText(false);
+    if (!graphicsBuffer)
+    {
+      displayChangedText();
+    }
+    else if (shadowBuffer)
+    {
+      displayChangedBytes();
+    }
+    else
+    {
+      sh1106TransferStart();
+      displayLayoutPages(0, 7);
+      sh1106TransferEnd();
+    }
+    markWrittenTextClean();
+    disableAutoDisplay = false;
+    if (framePosition != noFrame) { endFrame(); }
+#ifdef POLOLU_OLED_STATS
+    recordTime(stats.display, startMicros);
+#endif
+  }
+
+  /// @brief Starts writing all of the text/graphics to the OLED without
+  /// waiting for it to be sent.
+  ///
+  /// This is like display(), but if the core class can send data in the
+  /// background (see the "Core class" section), it only writes the first page
+  /// and returns.  Each later call to isBusy() writes the next page once the
+  /// core has finished sending the previous one.  Layouts without a graphics
+  /// buffer are written one changed line of text at a time instead.
+  ///
+  /// Each page is rendered just before it is written, so changes you make to
+  /// the text or graphics during the update will appear on the pages that
+  /// have not been written yet.
+  ///
+  /// If an update started by this function is still in progress, it starts
+  /// over, and its callback will not be called.  Calling display() finishes
+  /// the update immediately.
+  ///
+  /// If the core class cannot send data in the background, this function
+  /// just calls display() and then calls the callback.
+  ///
+  /// @param callback A function to call when the update is done, or nullptr.
+  ///   It is called from isBusy(), waitDone(), or display().
+  void displayAsync(void (*callback)() = nullptr)
+  {
+    displayAsync(callback, PololuOLEDHelpers::BoolConstant<
+      PololuOLEDHelpers::HasBusy<C>::value>());
   }
 
-  void display21x8Text()
+  /// @brief Continues an update started by displayAsync() and returns true if
+  /// it is still in progress.
+  ///
+  /// You should call this regularly (for example, every time through your
+  /// loop() function) after calling displayAsync(), because the next page of
+  /// the update is only written when this function sees that the core has
+  /// finished sending the previous one.
+  bool isBusy()
   {
-    core.sh1106TransferStart();
-    writeSegmentText(0, 2, getLinePointer(0), 21);
-    writeSegmentText(1, 2, getLinePointer(1), 21);
-    writeSegmentText(2, 2, getLinePointer(2), 21);
-    writeSegmentText(3, 2, getLinePointer(3), 21);
-    writeSegmentText(4, 2, getLinePointer(4), 21);
-    writeSegmentText(5, 2, getLinePointer(5), 21);
-    writeSegmentText(6, 2, getLinePointer(6), 21);
-    writeSegmentText(7, 2, getLinePointer(7), 21);
-    core.sh1106TransferEnd();
+    if (coreBusy()) { return true; }
+    if (framePosition == noFrame) { return false; }
+    if (frameRemaining())
+    {
+      displayNextFramePart();
+      return true;
+    }
+    endFrame();
+    return false;
   }
 
-  void display21x8TextAndGraphicsPartial(uint8_t x, uint8_t y, uint8_t width)
+  /// @brief Waits for an update started by displayAsync() to finish.
+  void waitDone()
   {
-    if (x >= 21 || y >= 8) { return; }
-    if (width > (uint8_t)(21 - x)) { width = 21 - x; }
-    if (width == 0) { return; }
-
-    const uint8_t columnAddr = 2 + x * 6;
-    uint8_t * const text = getLinePointer(y) + x;
-
-    core.sh1106TransferStart();
-    writeSegmentTextAndGraphics(y, columnAddr, text, width);
-    core.sh1106TransferEnd();
+    while (isBusy()) {}
   }
 
-  void display21x8TextAndGraphics()
+  /// @brief Writes the next part of an incremental update of the OLED.
+  ///
+  /// This lets you spread the work done by display() over several calls, so
+  /// that no single call takes long.  Each call writes one page (1/8 of the
+  /// screen) for layouts with a graphics buffer, or one changed line of text
+  /// for other layouts.  If no update is in progress, this function starts a
+  /// new one, which writes the same things that display() would.
+  ///
+  /// Each page is rendered just before it is written, so changes you make to
+  /// the text or graphics during the update will appear on the pages that
+  /// have not been written yet.  Calling display() finishes the update
+  /// immediately.
+  ///
+  /// @return True if the update is complete, or false if there is more to
+  ///   write.
+  bool displayStep()
   {
-    core.sh1106TransferStart();
-    writePageTextAndGraphics(0, getLinePointer(0), 0, 21);
-    writePageTextAndGraphics(1, getLinePointer(1), 0, 21);
-    writePageTextAndGraphics(2, getLinePointer(2), 0, 21);
-    writePageTextAndGraphics(3, getLinePointer(3), 0, 21);
-    writePageTextAndGraphics(4, getLinePointer(4), 0, 21);
-    writePageTextAndGraphics(5, getLinePointer(5), 0, 21);
-    writePageTextAndGraphics(6, getLinePointer(6), 0, 21);
-    writePageTextAndGraphics(7, getLinePointer(7), 0, 21);
-    core.sh1106TransferEnd();
+    if (framePosition == noFrame) { startFrame(nullptr); }
+    if (frameRemaining()) { displayNextFramePart(); }
+    if (frameRemaining()) { return false; }
+    endFrame();
+    return true;
   }
 
-public:
-
-  /// @brief Writes all of the text/graphics to the OLED.
+  /// @brief Writes as much of an incremental update of the OLED as fits in
+  /// the specified amount of time.
   ///
-  /// This also turns on auto display mode, undoing the effect of
-  /// noAutoDisplay().
+  /// This calls displayStep() repeatedly.  It always calls it at least once,
+  /// and then it only calls it again if the slowest step so far would still
+  /// finish within the time budget.
   ///
-  /// Note that this function does not always write to the entire display:
-  /// for text-only modes, it will normally only write to the portion of the
-  /// screen containing text.
-  void display()
+  /// @param budgetMicros The time budget, in microseconds.
+  /// @return True if the update is complete, or false if there is more to
+  ///   write.
+  bool displayFor(uint32_t budgetMicros)
   {
-    init();
-    if (clearDisplayRamOnNextDisplay) { clearDisplayRam(); }
-    ((*this).*(displayFunction))();
-    disableAutoDisplay = false;
+    return PololuOLEDHelpers::displayStepsFor(*this, budgetMicros);
   }
 
   /// @brief Writes a certain region of text/graphics to the OLED.
@@ -804,7 +2716,8 @@ public:
   /// This function is like display(), but it only writes text/graphics to the
   /// OLED which are in a region corresponding to one or more consecutive
   /// characters in a line of text.
-  /// This function cannot write arbitrary regions.
+  /// This function cannot write arbitrary regions, but displayGraphicsRect()
+  /// can.
   ///
   /// Most users will not need to call this because the clear(), write(), and
   /// print() functions automatically write to the display as needed.
@@ -821,14 +2734,264 @@ public:
   /// @param width The number of characters to update.
   void displayPartial(uint8_t x, uint8_t y, uint8_t width)
   {
+#ifdef POLOLU_OLED_STATS
+    const uint32_t startMicros = micros();
+#endif
     init();
     if (clearDisplayRamOnNextDisplay) { clearDisplayRam(); }
-    ((*this).*(displayPartialFunction))(x, y, width);
+    if (textBackBuffer)
+    {
+      snapshotText(x, y, width);
+    }
+    else
+    {
+      setDirty(x, y, width, false);
+    }
+    displayLayoutPartial(x, y, width);
+#ifdef POLOLU_OLED_STATS
+    recordTime(stats.displayPartial, startMicros);
+#endif
+  }
+
+  /// @brief Writes a rectangular region of the screen to the OLED.
+  ///
+  /// This is for layouts with a graphics buffer.  It writes the graphics in
+  /// the specified rectangle, combined with any text of the current layout in
+  /// it, and nothing else, so it is much faster than display() after you
+  /// change a small area of the graphics buffer.
+  ///
+  /// The SH1106 stores pixels in pages that are 8 pixels tall, so the
+  /// rectangle is extended up and down to the edges of the pages it covers.
+  ///
+  /// Text in the rectangle is written as it is in the text buffer, but it is
+  /// not marked as clean, so display() still writes it.
+  ///
+  /// @param x The left edge of the rectangle (0 to 127).
+  /// @param y The top edge of the rectangle (0 to 63).
+  /// @param width The width of the rectangle, in pixels.
+  /// @param height The height of the rectangle, in pixels.
+  void displayGraphicsRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+  {
+    if (!graphicsBuffer || x >= 128 || y >= 64) { return; }
+    if (width > (uint8_t)(128 - x)) { width = 128 - x; }
+    if (height > (uint8_t)(64 - y)) { height = 64 - y; }
+    if (width == 0 || height == 0) { return; }
+
+    init();
+    if (clearDisplayRamOnNextDisplay)
+    {
+      display();
+      return;
+    }
+
+    const uint8_t firstPage = y >> 3;
+    const uint8_t lastPage = (y + height - 1) >> 3;
+    uint16_t * const signatures = pageSignatures;
+    pageSignatures = nullptr;
+
+    // The page routines write whole pages, and writeClipped() drops the
+    // bytes outside the rectangle.
+    Clip rect = { &PololuSH1106Main::writeClipped, x, (uint8_t)(x + width),
+      0, 0, false, nullptr };
+    sh1106TransferStart();
+    clip = &rect;
+    displayLayoutPages(firstPage, lastPage);
+    clip = nullptr;
+    sh1106TransferEnd();
+
+    pageSignatures = signatures;
+    for (uint8_t page = firstPage; page <= lastPage; page++)
+    {
+      forgetPageSignatures(1 << page);
+    }
+  }
+
+  /// @brief Marks characters in the text buffer as changed.
+  ///
+  /// This tells the library that the specified characters need to be written
+  /// to the OLED by the next call to display().  You only need to call this if
+  /// you modify the text buffer using a pointer from getLinePointer() that you
+  /// got before the last call to display().
+  ///
+  /// @param x The column number of the first character (0 means left-most
+  ///          column).
+  /// @param y The row number (0 means top row).
+  /// @param width The number of characters.
+  void markDirty(uint8_t x, uint8_t y, uint8_t width = 1)
+  {
+    setDirty(x, y, width, true);
+  }
+
+  /// @brief Marks every character in the text buffer as changed.
+  ///
+  /// This makes the next call to display() write all of the text, which is
+  /// useful if the contents of the OLED's RAM were changed without using this
+  /// class.
+  void markAllDirty()
+  {
+    for (uint8_t y = 0; y < textBufferHeight; y++)
+    {
+      setDirty(0, y, textBufferWidth, true);
+    }
+  }
+
+  /// @brief Makes display() skip pages that have not changed.
+  ///
+  /// In this mode, layouts with a graphics buffer remember a 16-bit checksum
+  /// of the graphics and text that was last written to each page of the
+  /// screen, and display() only writes the pages whose checksum has changed.
+  /// This can greatly reduce the amount of data sent when only a small part of
+  /// the graphics buffer changes between calls to display().
+  ///
+  /// This mode has no effect on layouts without a graphics buffer.
+  ///
+  /// @param signatures A pointer to an array of 8 uint16_t values where this
+  ///   class stores the checksums, which must stay valid until you call
+  ///   noSkipUnchangedPages().  The array is cleared by this function, so
+  ///   the next call to display() writes every page.
+  ///
+  /// Keeping the checksums in an array that you provide means that sketches
+  /// that do not use this mode do not need RAM for them:
+  ///
+  /// ```{.cpp}
+  /// uint16_t pageSignatures[8];
+  ///
+  /// void setup()
+  /// {
+  ///   display.setLayout21x8WithGraphics(graphics);
+  ///   display.skipUnchangedPages(pageSignatures);
+  /// }
+  /// ```
+  ///
+  /// If you modify the display's RAM without using this class, you should
+  /// call this function again or reinitialize() afterwards so that the next
+  /// call to display() writes every page.
+  void skipUnchangedPages(uint16_t * signatures)
+  {
+    pageSignatures = signatures;
+    forgetPageSignatures(0xFF);
+  }
+
+  /// @brief Makes display() write every page (the default).
+  ///
+  /// See skipUnchangedPages().  After this, the array passed to
+  /// skipUnchangedPages() is no longer used.
+  void noSkipUnchangedPages()
+  {
+    pageSignatures = nullptr;
+  }
+
+  /// @brief Makes display() write only the bytes that changed, using a copy of
+  /// what the OLED is showing.
+  ///
+  /// @param shadow A pointer to a PololuSH1106ShadowBuffer, or nullptr to
+  ///   stop using one.
+  ///
+  /// This class copies every byte it writes to the OLED's RAM to the shadow
+  /// buffer.  In layouts with a graphics buffer, display() then renders each
+  /// page of graphics and text, compares it to the shadow buffer, and only
+  /// writes the runs of bytes that are different.  This sends much less data
+  /// than skipUnchangedPages() when a few pixels change on every page, at the
+  /// cost of the RAM for the shadow buffer.
+  ///
+  /// Starting a new run takes 3 command bytes, so runs that are separated by
+  /// only a few unchanged bytes are written as one run.  The core class can
+  /// tune this with the optional sh1106RunCost() function (see the "Core
+  /// class" section).
+  ///
+  /// This class does not know what the OLED is showing when you call this
+  /// function, so the next call to display() clears the OLED's RAM and the
+  /// shadow buffer first.  If you modify the display's RAM without using
+  /// this class, call this function again.
+  ///
+  /// This has no effect on layouts without a graphics buffer, which already
+  /// only write the text that changed.
+  void setShadowBuffer(PololuSH1106ShadowBuffer * shadow)
+  {
+    shadowBuffer = shadow;
+    if (shadow)
+    {
+      shadow->remaining = 0;
+      shadow->writePageChanges = &writePageChangesOf;
+      clearDisplayRamOnNextDisplay = true;
+    }
+  }
+
+#ifdef POLOLU_OLED_STATS
+  /// @brief Returns the statistics recorded since the last call to
+  /// resetStats().
+  ///
+  /// This function is only available if POLOLU_OLED_STATS is defined.
+  const PololuSH1106Stats & getStats() const
+  {
+    return stats;
+  }
+
+  /// @brief Resets all of the statistics returned by getStats().
+  ///
+  /// This function is only available if POLOLU_OLED_STATS is defined.
+  void resetStats()
+  {
+    stats = PololuSH1106Stats();
+    stats.display.minMicros = stats.displayPartial.minMicros = 0xFFFFFFFF;
+  }
+
+private:
+  static void recordTime(PololuSH1106TimeStats & t, uint32_t startMicros)
+  {
+    const uint32_t duration = micros() - startMicros;
+    t.count++;
+    t.totalMicros += duration;
+    if (duration < t.minMicros) { t.minMicros = duration; }
+    if (duration > t.maxMicros) { t.maxMicros = duration; }
   }
 
+public:
+#endif
+
 
   //////// Text
 
+  /// @brief Starts accumulating text changes instead of writing them to the
+  /// OLED immediately.
+  ///
+  /// After calling this, functions like write(), print(), and clear() only
+  /// change the text buffer, even in auto display mode.  When you call
+  /// endUpdate(), the changed region of each line of text is written to the
+  /// OLED with a single partial update.
+  ///
+  /// Calls to beginUpdate() and endUpdate() can be nested; the changes are
+  /// written when the outermost endUpdate() is called.
+  void beginUpdate()
+  {
+    updateDepth++;
+  }
+
+  /// @brief Writes the changes accumulated since beginUpdate() to the OLED.
+  ///
+  /// See beginUpdate().
+  void endUpdate()
+  {
+    if (updateDepth == 0) { return; }
+    if (--updateDepth == 0) { flush(); }
+  }
+
+  /// @brief Writes any accumulated text changes to the OLED.
+  ///
+  /// In auto display mode, this writes the changed region of each line of text
+  /// to the OLED with a single partial update.  It does nothing in
+  /// noAutoDisplay() mode; call display() instead.
+  ///
+  /// This function overrides Print::flush(), and it is called by endUpdate().
+  void flush() override
+  {
+    if (disableAutoDisplay) { return; }
+    for (uint8_t y = 0; y < textBufferHeight; y++)
+    {
+      displayDirtySpan(y);
+    }
+  }
+
   /// @brief Turns off auto display mode.
   ///
   /// This causes the clear(), write(), and print() functions to not perform
@@ -841,27 +3004,59 @@ public:
     disableAutoDisplay = true;
   }
 
+  /// @brief Turns on double-buffered text mode, using the specified buffer.
+  ///
+  /// In this mode, the functions that change the text (like write(), print(),
+  /// clear(), and getLinePointer()) use the back buffer you provide, while the
+  /// display routines read a separate copy of the text.  display(),
+  /// displayPartial(), and displayAsync() copy the back buffer (or the part
+  /// they are writing) to that copy with interrupts disabled before they start
+  /// writing to the OLED, so text changed by an interrupt while the OLED is
+  /// being updated cannot cause a partly-updated (torn) frame.  Characters
+  /// that change during an update are written by the next one.
+  ///
+  /// The buffer must be as big as the text buffer (168 bytes by default) and
+  /// must stay valid until you call this function again.  The current text is
+  /// copied to it.  Pass nullptr to turn off double-buffered mode.
+  ///
+  /// If you change the text from an interrupt, you should normally call
+  /// noAutoDisplay() so that the interrupt does not write to the OLED, and
+  /// call display() from your main loop instead.  On AVR and ARM Cortex-M,
+  /// display(), displayPartial(), and displayAsync() put the interrupt state
+  /// back the way it was after copying the text.  On other architectures,
+  /// they enable interrupts.
+  void setTextBackBuffer(uint8_t * buffer)
+  {
+    if (textBackBuffer) { memcpy(textBuffer, textBackBuffer, sizeof(textBuffer)); }
+    if (buffer) { memcpy(buffer, textBuffer, sizeof(textBuffer)); }
+    textBackBuffer = buffer;
+  }
+
   /// @brief Gets a pointer to a line of text in this library's text buffer.
   ///
   /// This is for advanced users who want to use their own code to directly
   /// manipulate the text buffer.
   ///
-  /// The returned pointer will point to a region of memory at least 21 bytes
-  /// long that holds the specified line of text.  You can perform arbitrary
-  /// operations on these bytes.
+  /// The returned pointer will point to a region of memory textBufferWidth
+  /// bytes long (21 by default) that holds the specified line of text.  You
+  /// can perform arbitrary operations on these bytes.
   ///
   /// Note that you should not assume anything about where the lines are in
   /// relation to each other, and you should not assume it is safe to write
-  /// beyond the 21st byte of a line.
+  /// beyond the first textBufferWidth bytes of a line.
   ///
   /// Note that functions like snprintf will add a null (0) character at the
   /// end of their output.  This is probably undesirable if you have configured
   /// character 0 to be a custom character using loadCustomCharacter().
-  /// Also, it means that the maximum content they can safely write to the text
-  /// buffer is limited to 19 characters.
+  /// Also, it means that the maximum content they can safely write to a line
+  /// of the text buffer is textBufferWidth - 1 characters.
+  ///
+  /// This function marks the entire line as dirty (see markDirty()), so the
+  /// next call to display() will write it.
   uint8_t * getLinePointer(uint8_t line)
   {
-    return textBuffer + line * textBufferWidth;
+    setDirty(0, line, textBufferWidth, true);
+    return editLine(line);
   }
 
   /// @brief Changes the location of the text cursor.
@@ -884,13 +3079,153 @@ public:
   uint8_t getY() { return textCursorY; }
 
   /// @brief Moves all the text up one row. (Does not change the cursor position.)
+  ///
+  /// In hardwareScroll() mode with setLayout21x8(), the OLED moves the image
+  /// up using its display start line, so this only has to write the new
+  /// bottom line instead of the whole screen.
   void scrollDisplayUp()
   {
-    memmove(textBuffer, textBuffer + textBufferWidth, textBufferWidth * (textBufferHeight - 1));
-    memset(textBuffer + textBufferWidth * (textBufferHeight - 1), ' ', textBufferWidth);
-    if (!disableAutoDisplay) { display(); }
+    if (canScrollInHardware())
+    {
+      scrollDisplayUpInHardware();
+      return;
+    }
+
+    for (uint8_t y = 0; y < textBufferHeight; y++)
+    {
+      const uint8_t * next = y + 1 < textBufferHeight ? editLine(y + 1) : nullptr;
+      for (uint8_t x = 0; x < textBufferWidth; x++)
+      {
+        storeCharacter(x, y, next ? next[x] : ' ');
+      }
+    }
+    if (autoDisplayNow()) { display(); }
+  }
+
+  /// @brief Makes scrollDisplayUp() and terminalMode() scroll the OLED in
+  /// hardware when using setLayout21x8().
+  ///
+  /// In this mode, scrolling the text up moves the display start line (see
+  /// setDisplayStartLine()) down by one page so that the OLED shows every
+  /// line one row higher, and then only the bottom line needs to be written.
+  /// This takes about 130 bytes instead of about 1100.
+  ///
+  /// The new start line is sent in the same transfer as the bottom line, so
+  /// in noAutoDisplay() mode or between beginUpdate() and endUpdate(), the
+  /// OLED does not change until the text is written.
+  ///
+  /// This mode also works with the other layouts that have 8 rows of text
+  /// and no graphics, like setLayoutTiles().  It has no effect on layouts
+  /// with graphics, because the graphics would move along with the text, or
+  /// when setFont() or setCompressedFont() is only used by some of the lines.
+  /// To scroll graphics smoothly, use setDisplayStartLine() instead.
+  void hardwareScroll()
+  {
+    hardwareScrollEnabled = true;
+  }
+
+  /// @brief Makes scrollDisplayUp() rewrite the text instead of scrolling the
+  /// OLED in hardware (the default).
+  ///
+  /// See hardwareScroll().  This does not change the display start line.
+  void noHardwareScroll()
+  {
+    hardwareScrollEnabled = false;
+  }
+
+  /// @brief Makes write() and print() behave like a simple terminal.
+  ///
+  /// In this mode, the text uses the rows and columns shown by the current
+  /// layout, and these characters have special effects:
+  ///
+  /// - `'\n'` moves the cursor to the start of the next row.
+  /// - `'\r'` moves the cursor to the start of the current row.
+  /// - `'\b'` and DEL (127) move the cursor back one column and erase the
+  ///   character there.
+  /// - `'\f'` (Ctrl+L) clears the text and moves the cursor to the upper
+  ///   left.
+  /// - `'\t'` moves the cursor to the next column that is a multiple of 4.
+  ///
+  /// Writing a character when the cursor is past the end of a row first moves
+  /// the cursor to the start of the next row.  Moving the cursor down from the
+  /// bottom row scrolls the text up by one row.  The top row is saved in the
+  /// scrollback buffer, if there is one (see setScrollbackBuffer()), and
+  /// with setLayout21x8() in hardwareScroll() mode, the scrolling is done by
+  /// the OLED.
+  ///
+  /// Each call to write() writes the lines it changed to the OLED once, at
+  /// the end, so printing many lines at once costs little more than printing
+  /// the last screenful.
+  void terminalMode()
+  {
+    terminalEnabled = true;
+  }
+
+  /// @brief Makes write() and print() store every character in the text
+  /// buffer as it is, and not scroll (the default).
+  ///
+  /// See terminalMode().
+  void noTerminalMode()
+  {
+    terminalEnabled = false;
+  }
+
+  /// @brief Sets a buffer that holds the lines that scroll off the top in
+  /// terminalMode().
+  ///
+  /// @param buffer A pointer to a PololuSH1106ScrollbackBuffer, which can
+  /// hold up to 255 lines.  Any lines already in it are discarded.
+  ///
+  /// The buffer is used as a ring, so saving a line does not move the
+  /// others; when it is full, each new line replaces the oldest one.  Use
+  /// setScrollbackView() to show the saved lines.
+  template <uint8_t lineCount>
+  void setScrollbackBuffer(
+    PololuSH1106ScrollbackBuffer<lineCount, textBufferWidth> * buffer)
+  {
+    noScrollbackBuffer();
+    buffer->next = 0;
+    buffer->count = 0;
+    buffer->view = 0;
+    scrollback = buffer;
+  }
+
+  /// @brief Stops saving the lines that scroll off the top (the default).
+  ///
+  /// See setScrollbackBuffer().
+  void noScrollbackBuffer()
+  {
+    setScrollbackView(0);
+    scrollback = nullptr;
+  }
+
+  /// @brief Scrolls the view back to show lines from the scrollback buffer.
+  ///
+  /// @param linesBack The number of saved lines to show above the text,
+  /// which moves down by the same number of rows.  0 (the default) shows the
+  /// text normally.  The number is limited to the number of saved lines.
+  ///
+  /// This only changes what is shown, not the text buffer.  Writing in
+  /// terminalMode() returns the view to 0.  In other modes, you should return
+  /// it to 0 before changing the text.
+  ///
+  /// By default, this function also calls display() to show the new view,
+  /// but noAutoDisplay() disables that behavior.
+  void setScrollbackView(uint8_t linesBack)
+  {
+    if (linesBack > getScrollbackCount()) { linesBack = getScrollbackCount(); }
+    if (linesBack == getScrollbackView()) { return; }
+    scrollback->view = linesBack;
+    markAllDirty();
+    if (autoDisplayNow()) { display(); }
   }
 
+  /// @brief Returns the number of saved lines shown by setScrollbackView().
+  uint8_t getScrollbackView() { return scrollback ? scrollback->view : 0; }
+
+  /// @brief Returns the number of lines in the scrollback buffer.
+  uint8_t getScrollbackCount() { return scrollback ? scrollback->count : 0; }
+
   /// @brief Clears the text and resets the text cursor to the upper left.
   ///
   /// After calling this function, the text buffer will consist entirely of
@@ -900,9 +3235,15 @@ public:
   /// to the OLED, but noAutoDisplay() disables that behavior.
   void clear()
   {
-    memset(textBuffer, ' ', sizeof(textBuffer));
+    for (uint8_t y = 0; y < textBufferHeight; y++)
+    {
+      for (uint8_t x = 0; x < textBufferWidth; x++)
+      {
+        storeCharacter(x, y, ' ');
+      }
+    }
     gotoXY(0, 0);
-    if (!disableAutoDisplay) { display(); }
+    if (autoDisplayNow()) { display(); }
   }
 
   /// @brief Writes a string of text.
@@ -913,18 +3254,29 @@ public:
   ///
   /// By default, this function also calls displayPartial() to write these
   /// changes to the OLED, but noAutoDisplay() disables that behavior.
+  /// Characters that are already present in the text buffer are not written
+  /// to the OLED again.
   ///
   /// There is no limit to how much text you can pass to this function, but
   /// the text will be discarded when you reach the end of the current line.
   ///
   /// To advance to the next line, use gotoXY().  The newline and carriage
   /// return characters do *not* have any special effect on the text cursor
-  /// position like they might have in a terminal emulator.
+  /// position like they might have in a terminal emulator, unless you call
+  /// terminalMode().
   ///
   /// This function is called by (certain overloads of) the print() function
   /// provided by the Arduino print class.
   size_t write(const uint8_t * buffer, size_t size) override
   {
+    if (terminalEnabled)
+    {
+      beginUpdate();
+      for (size_t i = 0; i < size; i++) { terminalWrite(buffer[i]); }
+      endUpdate();
+      return size;
+    }
+
     if (textCursorY >= textBufferHeight) { return 0; }
     if (textCursorX >= textBufferWidth) { return 0; }
     if (size > (uint8_t)(textBufferWidth - textCursorX))
@@ -932,11 +3284,20 @@ public:
       size = textBufferWidth - textCursorX;
     }
 
-    memcpy(getLinePointer(textCursorY) + textCursorX, buffer, size);
+    // Find the range of characters that actually changed.
+    uint8_t first = 0xFF, last = 0;
+    for (uint8_t i = 0; i < size; i++)
+    {
+      if (storeCharacter(textCursorX + i, textCursorY, buffer[i]))
+      {
+        if (first == 0xFF) { first = i; }
+        last = i;
+      }
+    }
 
-    if (!disableAutoDisplay)
+    if (autoDisplayNow() && first != 0xFF)
     {
-      displayPartial(textCursorX, textCursorY, size);
+      displayPartial(textCursorX + first, textCursorY, last - first + 1);
     }
 
     textCursorX += size;
@@ -949,12 +3310,12 @@ public:
   /// write(const uint8_t *, size_t).
   size_t write(uint8_t d) override
   {
+    if (terminalEnabled) { return write(&d, 1); }
+
     if (textCursorY >= textBufferHeight) { return 0; }
     if (textCursorX >= textBufferWidth) { return 0; }
 
-    *(getLinePointer(textCursorY) + textCursorX) = d;
-
-    if (!disableAutoDisplay)
+    if (storeCharacter(textCursorX, textCursorY, d) && autoDisplayNow())
     {
       displayPartial(textCursorX, textCursorY, 1);
     }
@@ -968,21 +3329,10 @@ public:
   /// @param number A character code between 0 and 7.
   void loadCustomCharacterFromRam(const uint8_t * picture, uint8_t number)
   {
-    uint8_t * columns = customChars[number];
-    for (uint8_t i = 0; i < 5; i++)
-    {
-      columns[i] = 0;
-    }
-    for (uint8_t i = 0; i < 8; i++)
-    {
-      uint8_t row = picture[i];
-      uint8_t mask = 1 << i;
-      if (row & (1 << 0)) { columns[4] |= mask; }
-      if (row & (1 << 1)) { columns[3] |= mask; }
-      if (row & (1 << 2)) { columns[2] |= mask; }
-      if (row & (1 << 3)) { columns[1] |= mask; }
-      if (row & (1 << 4)) { columns[0] |= mask; }
-    }
+    static_assert(!sharedCustomChars, "This display shares its custom "
+      "characters.  Define them with PololuSH1106Multi.");
+    PololuOLEDHelpers::customCharacterColumns(picture, customChars[number]);
+    customCharacterChanged(number);
   }
 
   /// @brief Defines a custom character.
@@ -1006,6 +3356,168 @@ public:
     loadCustomCharacter((const uint8_t *)picture, number);
   }
 
+  /// @brief Sets a proportional font for the 21x8 layouts.
+  ///
+  /// @param font A pointer to the font, which must stay valid while it is
+  /// used, or nullptr to draw all the text with the built-in font.
+  /// @param lines A bit mask of the lines of text that use the font: bit N
+  /// is 1 if line N uses it.  The other lines use the built-in font.
+  ///
+  /// Each glyph of the font only takes up as much room as it needs, so lines
+  /// that use it can fit more text.  They show characters up to the end of
+  /// the text buffer or the right edge of the screen, whichever comes first,
+  /// so you might want to make the text buffer wider with the
+  /// textBufferWidth template parameter (see "Text buffer size").
+  ///
+  /// Writing a character to a line that uses the font also writes the rest
+  /// of the line, since the characters after it might have moved.
+  ///
+  /// This replaces any font set by setCompressedFont(), and has no effect on
+  /// the other layouts.
+  void setFont(const PololuOLEDFont * font, uint8_t lines = 0xFF)
+  {
+    textFont = font;
+    fontLines = font ? lines : 0;
+    fontLineFunction = &writeFontLineOf;
+    forgetPageSignatures(0xFF);
+    markAllDirty();
+  }
+
+  /// @brief Sets a compressed fixed-width font for the 21x8 layouts.
+  ///
+  /// @param font A pointer to the font, which must stay valid while it is
+  /// used, or nullptr to draw all the text with the built-in font.
+  /// @param lines A bit mask of the lines of text that use the font: bit N
+  /// is 1 if line N uses it.  The other lines use the built-in font.
+  ///
+  /// The glyphs are decoded while they are sent to the display, at the cost
+  /// of some extra time for each character drawn.  You can make a compressed
+  /// font from an X BitMap file with extras/compress_font.py.
+  ///
+  /// Characters that are not in the font are drawn with the built-in font,
+  /// so pololuOledFont stays in your program.  A compressed font takes less
+  /// program space than the same font stored uncompressed, but using one
+  /// always adds to the size of your program, because of the font tables
+  /// and the code that decodes them.
+  /// This replaces any font set by setFont(), and has no effect on the other
+  /// layouts.
+  void setCompressedFont(const PololuOLEDCompressedFont * font, uint8_t lines = 0xFF)
+  {
+    compressedFont = font;
+    fontLines = font ? lines : 0;
+    fontLineFunction = &writeCompressedFontLineOf;
+    forgetPageSignatures(0xFF);
+    markAllDirty();
+  }
+
+private:
+
+  // Returns true if the text should be scrolled with the display start line
+  // (see hardwareScroll()).  Each row of text must be one page of the OLED,
+  // and there must be no graphics, which would move along with the text.
+  bool canScrollInHardware()
+  {
+    return hardwareScrollEnabled && getLayoutHeight() == 8 && !graphicsBuffer &&
+      (fontLines == 0 || fontLines == 0xFF);
+  }
+
+  // Moves the text and dirty bits up one row, moves the display start line
+  // by one page to match, and marks the new bottom row as dirty, since the
+  // OLED will show the old top row there.  The start line is sent along with
+  // the new bottom row, so the OLED does not change before that row is
+  // written.
+  void scrollDisplayUpInHardware()
+  {
+    init();
+    waitDone();
+    for (uint8_t y = 0; y + 1 < textBufferHeight; y++)
+    {
+      memcpy(editLine(y), editLine(y + 1), textBufferWidth);
+      if (textBackBuffer) { memcpy(frontLine(y), frontLine(y + 1), textBufferWidth); }
+      memcpy(dirtyCells[y], dirtyCells[y + 1], sizeof(dirtyCells[y]));
+    }
+    memset(editLine(textBufferHeight - 1), ' ', textBufferWidth);
+    setDirty(0, textBufferHeight - 1, textBufferWidth, true);
+    moveStartLine(startLine + 8);
+    if (autoDisplayNow()) { display(); }
+  }
+
+  // Moves the text cursor to the start of the next row of the terminal,
+  // scrolling the terminal rows up if it is on the bottom row.
+  void terminalNewLine()
+  {
+    textCursorX = 0;
+    if (textCursorY + 1 < getLayoutHeight())
+    {
+      textCursorY++;
+      return;
+    }
+    textCursorY = getLayoutHeight() - 1;
+
+    PololuSH1106Scrollback * const s = scrollback;
+    if (s)
+    {
+      memcpy(scrollbackLine(s->size), editLine(0), textBufferWidth);
+      if (++s->next == s->size) { s->next = 0; }
+      if (s->count < s->size) { s->count++; }
+    }
+
+    if (canScrollInHardware())
+    {
+      scrollDisplayUpInHardware();
+      return;
+    }
+    for (uint8_t y = 0; y < getLayoutHeight(); y++)
+    {
+      const uint8_t * next =
+        y + 1 < getLayoutHeight() ? editLine(y + 1) : nullptr;
+      for (uint8_t x = 0; x < textBufferWidth; x++)
+      {
+        storeCharacter(x, y, next ? next[x] : ' ');
+      }
+    }
+  }
+
+  // Handles one character written in terminalMode().  This is only called
+  // between beginUpdate() and endUpdate(), so it does not write to the OLED.
+  void terminalWrite(uint8_t c)
+  {
+    if (getScrollbackView()) { setScrollbackView(0); }
+    switch (c)
+    {
+    case '\n':
+      terminalNewLine();
+      return;
+    case '\r':
+      textCursorX = 0;
+      return;
+    case '\b':
+    case 0x7F:
+      if (textCursorX == 0) { return; }
+      if (textCursorX > getLayoutWidth()) { textCursorX = getLayoutWidth(); }
+      textCursorX--;
+      if (textCursorY < getLayoutHeight())
+      {
+        storeCharacter(textCursorX, textCursorY, ' ');
+      }
+      return;
+    case '\f':
+      clear();
+      return;
+    case '\t':
+      textCursorX = (textCursorX | 3) + 1;
+      if (textCursorX > getLayoutWidth()) { textCursorX = getLayoutWidth(); }
+      return;
+    }
+    if (textCursorX >= getLayoutWidth() || textCursorY >= getLayoutHeight())
+    {
+      terminalNewLine();
+    }
+    storeCharacter(textCursorX++, textCursorY, c);
+  }
+
+public:
+
   //////// Member variables and constants
 
   /// This object handles all low-level communication with the SH1106.
@@ -1013,24 +3525,116 @@ public:
 
 private:
 
-  bool initialized;
+  // These flags are bit fields so that they share one byte.
+  bool initialized : 1;
+  bool clearDisplayRamOnNextDisplay : 1;
+  bool disableAutoDisplay : 1;
+  bool hardwareScrollEnabled : 1;
+  bool terminalEnabled : 1;
+
+  // True if the start line (see below) has not been sent yet.
+  bool startLinePending : 1;
+
+  // The number of calls to sh1106TransferStart() without a matching
+  // sh1106TransferEnd().
+  uint8_t transferDepth;
+
+  // The number of calls to beginUpdate() without a matching endUpdate().
+  uint8_t updateDepth;
+
+  // The clipped write in progress (see Clip), or nullptr.
+  Clip * clip;
 
-  bool clearDisplayRamOnNextDisplay;
+  // The copy of the OLED's RAM set by setShadowBuffer(), or nullptr.
+  PololuSH1106ShadowBuffer * shadowBuffer;
 
-  bool disableAutoDisplay;
+  // The display start line of the SH1106 (0 to 63).  See setDisplayStartLine().
+  uint8_t startLine;
 
-  // We use the display routines through these member function pointers and are
-  // careful about where we refer to them so that the routines for unused
-  // layouts do not take up program space.
-  void (PololuSH1106Main::*displayFunction)();
-  void (PololuSH1106Main::*displayPartialFunction)(uint8_t, uint8_t, uint8_t);
+  // The array passed to skipUnchangedPages(), which holds checksums of what
+  // was last written to each page (0 if the page has to be written), or
+  // nullptr.
+  uint16_t * pageSignatures;
 
-  static const uint8_t textBufferWidth = 21, textBufferHeight = 8;
+  // The font set by setFont() or setCompressedFont(), and a mask of the lines
+  // of the 21x8 layouts that use it.  fontLineFunction points to
+  // writeFontLine() or writeCompressedFontLine() once one of those has been
+  // called, so that they do not take up program space otherwise.
+  union
+  {
+    const PololuOLEDFont * textFont;
+    const PololuOLEDCompressedFont * compressedFont;
+  };
+  uint8_t fontLines;
+  void (*fontLineFunction)(PololuSH1106Main &, uint8_t, uint8_t, uint8_t);
+
+  // The next page (for layouts with graphics) or line of text (for other
+  // layouts) to be written by displayAsync(), or noFrame if it is not
+  // writing anything.
+  uint8_t framePosition;
+  static const uint8_t noFrame = 0xFF;
+
+  void (*frameCallback)();
 
   uint8_t textBuffer[textBufferHeight * textBufferWidth];
+
+  // The back buffer used in double-buffered mode (see setTextBackBuffer()),
+  // or nullptr.
+  uint8_t * textBackBuffer;
+
+  // The buffer set by setScrollbackBuffer(), or nullptr.
+  PololuSH1106Scrollback * scrollback;
+
+  // Bit X of dirtyCells[Y] is 1 if the character at column X and row Y of the
+  // text buffer needs to be written to the OLED.
+  uint8_t dirtyCells[textBufferHeight][(textBufferWidth + 7) / 8];
   uint8_t textCursorX;
   uint8_t textCursorY;
-  uint8_t customChars[8][5];
 
+  // The dot patterns of the custom characters, one byte per column.  A
+  // display managed by PololuSH1106Multi points to the table of the
+  // PololuSH1106Multi instead, so CustomChars is a pointer to the first row.
+  typedef typename PololuOLEDHelpers::Conditional<sharedCustomChars,
+    uint8_t (*)[5], uint8_t[8][5]>::type CustomChars;
+  CustomChars customChars;
+
+  // The graphics buffer of the current layout, or nullptr if the layout
+  // has no graphics.  If graphicsCallback is not nullptr, this points to the
+  // 128-byte strip it draws on instead.
   const uint8_t * graphicsBuffer;
+  void (*graphicsCallback)(uint8_t, uint8_t *);
+
+#ifdef POLOLU_OLED_STATS
+  PololuSH1106Stats stats;
+
+  // Whether the bytes being sent are data (true) or commands (false).
+  bool statsDataMode;
+#endif
+};
+
+/// @brief A version of PololuSH1106Main whose text buffer is only as big as
+/// one layout needs.
+///
+/// The Layout template parameter is PololuSH1106Layout8x2,
+/// PololuSH1106Layout11x4, or PololuSH1106Layout21x8.  The display starts
+/// out in that layout, and you can switch to the version of it with graphics
+/// (or a graphics callback), but selecting any other layout is a
+/// compile-time error.
+///
+/// The text buffer and the record of which characters changed are only as
+/// big as the layout needs.  The layout's geometry and display routines are
+/// chosen at compile time, so the display does not store them and calls the
+/// routines directly.  For example:
+///
+/// ```{.cpp}
+/// PololuSH1106Fixed<PololuSH1106Core, PololuSH1106Layout8x2> display;
+///
+/// void setup()
+/// {
+///   display.core.setPins(1, 30, 0, 17, 13);
+/// }
+/// ```
+template <class C, class Layout> class PololuSH1106Fixed
+  : public PololuSH1106Main<C, Layout::width, Layout::height, Layout>
+{
 };
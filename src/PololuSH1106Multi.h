@@ -0,0 +1,183 @@
+// Copyright (C) Pololu Corporation.  See www.pololu.com for details.
+
+/// @file PololuSH1106Multi.h
+///
+/// This file is not included by PololuOLED.h.  Include it directly if you want
+/// to use PololuSH1106Multi.
+
+#pragma once
+
+#include "PololuSH1106Main.h"
+
+/// @brief Manages several SH1106 displays that share one bus.
+///
+/// This class holds N instances of PololuSH1106Main, one for each display,
+/// for displays that share their clock, data, and DC lines but each have
+/// their own CS line.  You can use each display on its own with the []
+/// operator, and use this class to initialize them, define custom characters
+/// for all of them at once, and spread updates fairly between them.
+///
+/// If the displays also share a RES line, only pass that pin to the core of
+/// the first display, and call init() before using any of the displays, for
+/// example:
+///
+/// ```{.cpp}
+/// PololuSH1106Multi<PololuSH1106Core, 2> displays;
+///
+/// void setup()
+/// {
+///   displays[0].core.setPins(1, 30, 0, 17, 13);
+///   displays[1].core.setPins(1, 30, 255, 17, 14);
+///   displays.init();
+/// }
+/// ```
+///
+/// init() initializes the displays in order, so the first display resets all
+/// of them before any of the others are configured.  Otherwise, initializing
+/// one display would reset the others after they were configured.
+///
+/// The displays read their custom characters from one table kept in this
+/// class, instead of each keeping its own 40-byte copy, so every display
+/// shows the same custom characters.  Define them with the functions of this
+/// class: the functions of PololuSH1106Main that define custom characters
+/// cannot be used on these displays.
+///
+/// The core classes of the displays must not send data in the background
+/// (see the sh1106Busy() function in PololuSH1106Main), because each display
+/// only waits for its own core before using the bus.
+template <class C, uint8_t N> class PololuSH1106Multi
+{
+  static_assert(N >= 1 && N <= 8, "PololuSH1106Multi supports 1 to 8 displays.");
+
+public:
+  /// @brief The type of the displays: a PololuSH1106Main with a 21x8 text
+  /// buffer that reads the custom characters of this class.
+  typedef PololuSH1106Main<C, 21, 8, void, true> Display;
+
+  PololuSH1106Multi()
+  {
+    memset(customChars, 0, sizeof(customChars));
+    for (uint8_t i = 0; i < N; i++) { displays[i].customChars = customChars; }
+  }
+
+  /// @brief Returns a reference to one of the displays.
+  /// @param index A number from 0 to N - 1.
+  Display & operator[](uint8_t index)
+  {
+    return displays[index];
+  }
+
+  /// @brief Initializes the displays, in order, if they have not already been
+  /// initialized.
+  ///
+  /// See PololuSH1106Main::init().
+  void init()
+  {
+    for (uint8_t i = 0; i < N; i++) { displays[i].init(); }
+  }
+
+  /// @brief Reinitializes all of the displays, in order.
+  ///
+  /// See PololuSH1106Main::reinitialize().
+  void reinitialize()
+  {
+    for (uint8_t i = 0; i < N; i++) { displays[i].reinitialize(); }
+  }
+
+  /// @brief Defines a custom character on all of the displays.
+  ///
+  /// See PololuSH1106Main::loadCustomCharacterFromRam().
+  void loadCustomCharacterFromRam(const uint8_t * picture, uint8_t number)
+  {
+    PololuOLEDHelpers::customCharacterColumns(picture, customChars[number]);
+    for (uint8_t i = 0; i < N; i++)
+    {
+      displays[i].customCharacterChanged(number);
+    }
+  }
+
+  /// @brief Defines a custom character on all of the displays.
+  ///
+  /// See PololuSH1106Main::loadCustomCharacter().
+  void loadCustomCharacter(const uint8_t * picture, uint8_t number)
+  {
+    uint8_t ram_picture[8];
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      ram_picture[i] = pgm_read_byte(picture + i);
+    }
+    loadCustomCharacterFromRam(ram_picture, number);
+  }
+
+  /// @brief Defines a custom character on all of the displays.
+  ///
+  /// This overload is only provided for compatibility existing code that
+  /// defines char arrays instead of uint8_t arrays.
+  void loadCustomCharacter(const char * picture, uint8_t number)
+  {
+    loadCustomCharacter((const uint8_t *)picture, number);
+  }
+
+  /// @brief Calls display() for each display.
+  void display()
+  {
+    for (uint8_t i = 0; i < N; i++) { displays[i].display(); }
+    pendingDisplays = 0;
+  }
+
+  /// @brief Writes the next part of an incremental update of the displays.
+  ///
+  /// Each call calls PololuSH1106Main::displayStep() for one display, taking
+  /// turns between the displays that have not finished the current update, so
+  /// a display with a lot to write does not delay the others.  Displays whose
+  /// update is complete are skipped until all of them are complete.
+  ///
+  /// @return True if the update of every display is complete, or false if
+  ///   there is more to write.  The next call after it returns true starts a
+  ///   new update of all the displays.
+  bool displayStep()
+  {
+    if (pendingDisplays == 0)
+    {
+      pendingDisplays = (uint8_t)((1 << N) - 1);
+    }
+    while (!(pendingDisplays >> nextDisplay & 1))
+    {
+      if (++nextDisplay == N) { nextDisplay = 0; }
+    }
+
+    if (displays[nextDisplay].displayStep())
+    {
+      pendingDisplays &= ~(1 << nextDisplay);
+    }
+    if (++nextDisplay == N) { nextDisplay = 0; }
+    return pendingDisplays == 0;
+  }
+
+  /// @brief Writes as much of an incremental update of the displays as fits
+  /// in the specified amount of time.
+  ///
+  /// This calls displayStep() repeatedly, in the same way as
+  /// PololuSH1106Main::displayFor().
+  ///
+  /// @param budgetMicros The time budget, in microseconds.
+  /// @return True if the update of every display is complete, or false if
+  ///   there is more to write.
+  bool displayFor(uint32_t budgetMicros)
+  {
+    return PololuOLEDHelpers::displayStepsFor(*this, budgetMicros);
+  }
+
+private:
+  Display displays[N];
+
+  // The custom characters of all the displays, in the format of
+  // PololuSH1106Main.
+  uint8_t customChars[8][5];
+
+  // Bit N is 1 if display N has not finished the current update.
+  uint8_t pendingDisplays = 0;
+
+  // The display that displayStep() will try to update next.
+  uint8_t nextDisplay = 0;
+};
@@ -0,0 +1,185 @@
+// Copyright (C) Pololu Corporation.  See www.pololu.com for details.
+
+/// @file PololuSH1106SPI.h
+///
+/// This file is not included by PololuOLED.h because it depends on the Arduino
+/// SPI library.  Include it directly if you want to use PololuSH1106SPI.
+
+#pragma once
+
+#include <SPI.h>
+#include "PololuSH1106Main.h"
+
+/// @brief SH1106 core class implemented using the Arduino SPI library.
+///
+/// This is a core class for use as the template parameter for PololuSH1106Main.
+/// It is like PololuSH1106Core, but it uses the SPI peripheral of the
+/// microcontroller to drive the SH1106 CLK and MOS pins instead of toggling
+/// them with digitalWrite(), which makes updates much faster.
+///
+/// The SH1106 CLK pin must be connected to your board's hardware SPI SCK pin,
+/// and the SH1106 MOS pin must be connected to your board's hardware SPI MOSI
+/// pin.  The SPI peripheral cannot send the 9-bit words used in 3-wire SPI
+/// mode, so the SH1106 DC pin must be connected to an I/O pin.
+///
+/// Each transfer is wrapped in SPI.beginTransaction() and SPI.endTransaction(),
+/// so the SPI bus can be shared with other devices as long as the SH1106 CS
+/// pin is connected.
+class PololuSH1106SPICore
+{
+public:
+  /// @brief Configures what pins this class will use.
+  ///
+  /// This function should be called at the beginning of your program
+  /// before any functions that use the pins.
+  ///
+  /// For documentation of each parameter, see PololuSH1106SPI::PololuSH1106SPI().
+  void setPins(uint8_t res, uint8_t dc, uint8_t cs = 255)
+  {
+    resPin = res;
+    dcPin = dc;
+    csPin = cs;
+  }
+
+  /// @brief Sets the frequency of the SPI clock, in Hz.
+  ///
+  /// The default is 4000000 (4 MHz), which is the maximum serial clock
+  /// frequency given in the SH1106 datasheet.  The SPI library will use the
+  /// fastest frequency supported by your board that does not exceed this.
+  void setClockFrequency(uint32_t frequency)
+  {
+    settings = SPISettings(frequency, MSBFIRST, SPI_MODE0);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to perform any
+  /// initializations that might be needed for the other functions to work
+  /// properly.
+  void initPins()
+  {
+    if (resPin != 255) { pinMode(resPin, OUTPUT); }
+    pinMode(dcPin, OUTPUT);
+    if (csPin != 255)
+    {
+      digitalWrite(csPin, HIGH);
+      pinMode(csPin, OUTPUT);
+    }
+    SPI.begin();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to reset the SH1106.
+  void reset()
+  {
+    if (resPin == 255) { return; }
+    digitalWrite(resPin, LOW);
+    delayMicroseconds(10);
+    digitalWrite(resPin, HIGH);
+    delayMicroseconds(10);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to start a data
+  /// transfer to the SH1106.
+  void sh1106TransferStart()
+  {
+    SPI.beginTransaction(settings);
+    if (csPin != 255) { digitalWrite(csPin, LOW); }
+  }
+
+  /// @brief This function is called by PololuSH1106Main to end a data
+  /// transfer to the SH1106.
+  void sh1106TransferEnd()
+  {
+    if (csPin != 255) { digitalWrite(csPin, HIGH); }
+    SPI.endTransaction();
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are command bytes.
+  void sh1106CommandMode()
+  {
+    digitalWrite(dcPin, LOW);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to indicate that the
+  /// bytes it is about to pass to sh1106Write are data bytes.
+  void sh1106DataMode()
+  {
+    digitalWrite(dcPin, HIGH);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write commands or
+  /// data to the SH1106.
+  void sh1106Write(uint8_t d)
+  {
+    SPI.transfer(d);
+  }
+
+  /// @brief This function is called by PololuSH1106Main to write a run of
+  /// data bytes to the SH1106.
+  ///
+  /// SPI.transfer() overwrites its buffer with the received bytes, so the
+  /// data is copied to a small buffer on the stack first.
+  void sh1106WriteBuffer(const uint8_t * data, uint16_t length)
+  {
+    uint8_t buffer[16];
+    while (length)
+    {
+      uint8_t chunk = length < sizeof(buffer) ? length : sizeof(buffer);
+      memcpy(buffer, data, chunk);
+      SPI.transfer(buffer, chunk);
+      data += chunk;
+      length -= chunk;
+    }
+  }
+
+  /// @brief This function is called by PololuSH1106Main to find out how many
+  /// data bytes take as long to send as the commands that start a new run of
+  /// data (see PololuSH1106Main::setShadowBuffer()).
+  ///
+  /// Besides the 3 command bytes, starting a run toggles the DC pin twice
+  /// with digitalWrite(), which takes about as long as sending 3 more bytes
+  /// with SPI.transfer() at 4 MHz on an AVR.  For the generic
+  /// PololuSH1106Core, which sends every bit with digitalWrite(), a DC toggle
+  /// is negligible (and in 3-wire mode there is none), so it does not
+  /// implement this function and the default of 3 is used.
+  uint8_t sh1106RunCost()
+  {
+    return 6;
+  }
+
+private:
+  SPISettings settings = SPISettings(4000000, MSBFIRST, SPI_MODE0);
+  uint8_t resPin = 255, dcPin = 255, csPin = 255;
+};
+
+/// @brief SH1106 class that uses the Arduino SPI library.
+///
+/// To use this class, you must include PololuSH1106SPI.h.
+class PololuSH1106SPI : public PololuSH1106Main<PololuSH1106SPICore>
+{
+public:
+  /// @brief Creates a new instance of PololuSH1106SPI.
+  ///
+  /// The SH1106 CLK pin must be connected to your board's hardware SPI SCK
+  /// pin and the SH1106 MOS pin must be connected to your board's hardware
+  /// SPI MOSI pin, so they are not specified here.
+  ///
+  /// @param res The pin to use to control the
+  ///   SH1106 RES (reset) pin.
+  ///   If you are not using the RES pin, you can pass 255.
+  /// @param dc The pin to use to control the
+  ///   SH1106 DC/A0 (data mode / not command mode) pin.
+  ///   This pin is required: 3-wire SPI mode is not supported.
+  /// @param cs  Sets the pin to use to control the
+  ///   SH1106 CS (chip select) pin.
+  ///   If you are not using the CS pin, you can pass 255.
+  ///   In that case, you should ensure the SH1106's CS pin is driven low when
+  ///   you are communicating with it.
+  /// @param clockFrequency The SPI clock frequency to use, in Hz.
+  ///   See PololuSH1106SPICore::setClockFrequency().
+  PololuSH1106SPI(uint8_t res, uint8_t dc, uint8_t cs = 255,
+    uint32_t clockFrequency = 4000000)
+  {
+    core.setPins(res, dc, cs);
+    core.setClockFrequency(clockFrequency);
+  }
+};